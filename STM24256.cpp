@@ -1,6 +1,6 @@
 /**
   * @file    STM24256.cpp
-  * @version 1.2.2
+  * @version 2.4.1
   * @author  Adam Mitchell
   * @brief   C++ file of the STM24256 EEPROM driver module
   */
@@ -8,6 +8,18 @@
 /** Includes
  */
 #include "STM24256.h"
+#include "STM24256_Read_Cache.h"
+#include "STM24256_CRC.h"
+
+/** Page splits of constant operations are resolved at compile time
+ */
+static_assert(STM24256::Page_Slicer(0, STM24256::EEPROM_MEM_ARRAY_SIZE).count() == 
+              STM24256::EEPROM_MEM_ARRAY_SIZE / STM24256::EEPROM_PAGE_SIZE,
+              "Page_Slicer must split the whole memory array into whole pages");
+static_assert(STM24256::Page_Slicer(STM24256::EEPROM_PAGE_SIZE - 1, 2).count() == 2,
+              "Page_Slicer must split operations that straddle a page boundary");
+static_assert(STM24512::Page_Slicer(STM24256::EEPROM_PAGE_SIZE - 1, 2).count() == 1,
+              "Page_Slicer must split according to the page size of the part");
 
 /** Constructor. Create an EEPROM interface, connected to the pins specified 
  *  operating at the specified frequency
@@ -16,419 +28,1852 @@
  * @param sda I2C data line pin
  * @param scl I2C clock line pin
  * @param frequency_hz The bus frequency in hertz
+ * @param address_pins Levels of the E2, E1 and E0 address pins as bits 2, 1 and 0, so that
+ *                     several EEPROMs may share a bus. Pins that a part uses to select a
+ *                     bank are ignored. Defaults to all pins tied low
  */
-STM24256::STM24256(PinName write_control, PinName sda, PinName scl, int frequency_hz) :
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::STM24xxx(PinName write_control, PinName sda, PinName scl, int frequency_hz, int address_pins) :
                    _write_control(write_control, EEPROM_WRITE_DISABLE), 
                    _i2c(sda, scl), 
-                   _i2c_frequency_hz(frequency_hz)
+                   _device_select(EEPROM_MEM_ARRAY_ADDRESS_WRITE | ((address_pins & 0x07 & ~(EEPROM_BANK_COUNT - 1)) << 1)),
+                   _bus_hold_quantum(0),
+                   _i2c_frequency_hz(frequency_hz),
+                   _read_mode(EEPROM_READ_SEQUENTIAL),
+                   _address_counter(-1),
+                   _write_mode(EEPROM_WRITE_ALWAYS),
+                   _verify_mode(EEPROM_VERIFY_AFTER_WRITE),
+                   _write_cycle_timeout_us(10000),
+                   _write_cycle_pending(false),
+                   _event_queue(NULL),
+                   _async_address(0),
+                   _async_length(0),
+                   _async_data(NULL),
+                   _async_slicer(0, 0),
+                   _async_verify_slicer(0, 0),
+                   _async_last_slice(),
+                   _async_crc(0),
+                   _async_crc_expected(0),
+#if DEVICE_I2C_ASYNCH
+                   _scan_event(0),
+#endif
+                   _async_pending(false),
+                   _async_event(0),
+                   _async_verify(false),
+                   _async_write_cycle(false),
+                   _read_cache(NULL),
+                   _read_ahead_buffer(NULL),
+                   _read_ahead_size(0),
+                   _read_ahead_address(0),
+                   _read_ahead_length(0),
+                   _read_ahead_window(0),
+                   _read_ahead_next(-1),
+                   _last_write_cycle_us(0)
 {
+    _retry_policy.mode = EEPROM_RETRY_FIXED;
+    _retry_policy.max_attempts = 3;
+    _retry_policy.delay_us = 10000;
+    _retry_policy.max_delay_us = 10000;
+    _retry_policy.deadline_us = 0;
+
+    reset_retry_stats();
+    reset_bus_hold_stats();
+    reset_write_stats();
+
     disable_write();
     _i2c.frequency(_i2c_frequency_hz);
 }
 
-/** Destructor. Will disable write_control
+/** Destructor. Will disable write_control and cancel the queued step of any asynchronous write
+ *  still in progress, without invoking its callback. A step already being performed by the
+ *  event queue holds this driver, so the driver must outlive it
  */
-STM24256::~STM24256()
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::~STM24xxx()
 {
+    _mutex.lock();
+
+    if(_async_pending)
+    {
+        _event_queue->cancel(_async_event);
+        _async_pending = false;
+    }
+
+    _mutex.unlock();
+
     disable_write();
 }
 
 /** Set EEPROM write_control line to logic low; this allows the EEPROM to enter write mode
  */
-void STM24256::enable_write()
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::enable_write()
 {
     _write_control = EEPROM_WRITE_ENABLE;
 }
 
 /** Set EEPROM write_control line to logic high; this prevents the EEPROM from entering write mode
  */
-void STM24256::disable_write()
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::disable_write()
 {
    _write_control = EEPROM_WRITE_DISABLE; 
 }
 
-/** At the beginning of a read or write operation an address (to either read from, or write to)
- *  must be specified 
- * 
- * @param address 2 byte address pointing to where the operation will begin
- * @param send_stop Optionally generate an I2C stop condition on the bus
- * @return Indicates success or failure reason
+/** Take ownership of the I2C bus and begin timing how long it is held for
  */
-STM24256::EEPROM_Status_t STM24256::set_operation_address(uint16_t address, bool send_stop)
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::bus_lock()
 {
-    uint8_t address_msb = address >> 8;
-    uint8_t address_lsb = address & 0xFF;
-
     _i2c.lock();
 
-    _i2c.start();
+    _bus_hold_timer.reset();
+    _bus_hold_timer.start();
+}
 
-    if(_i2c.write(EEPROM_MEM_ARRAY_ADDRESS_WRITE) != mbed::I2C::ACK) 
-    {
-        _i2c.stop();
-        _i2c.unlock();
-        return EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY;
-    }
+/** Release the I2C bus and record how long it was held for
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::bus_unlock()
+{
+    _bus_hold_timer.stop();
+    int hold_us = _bus_hold_timer.read_us();
+
+    _i2c.unlock();
 
-    if(_i2c.write(address_msb) != mbed::I2C::ACK) 
+    int bucket = 0;
+    while(bucket < EEPROM_BUS_HOLD_BUCKETS - 1 && hold_us >= (1 << bucket))
     {
-        _i2c.stop();
-        _i2c.unlock();
-        return EEPROM_SET_OP_ADDRESS_FAIL_MSB;
+        bucket++;
     }
 
-    if(_i2c.write(address_lsb) != mbed::I2C::ACK) 
+    _bus_hold_histogram[bucket]++;
+
+    if(hold_us > _bus_hold_max_us)
     {
-        _i2c.stop();
-        _i2c.unlock();
-        return EEPROM_SET_OP_ADDRESS_FAIL_LSB;
+        _bus_hold_max_us = hold_us;
     }
+}
+
+/** Get the device select code, excluding the read bit, for the bank holding an address
+ * 
+ * @param address Address within the memory array
+ * @return The device select code to write to
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+int STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::get_device_select(uint32_t address)
+{
+    return _device_select | ((address / EEPROM_BANK_SIZE) << 1);
+}
 
-    if(send_stop) 
+/** Encode an address within the memory array as the address bytes that select it
+ * 
+ * @param address Address to encode
+ * @param address_bytes Char array of EEPROM_ADDRESS_BYTES in which to store the address bytes,
+ *                      most significant first
+ * @return The device select code to write to
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+int STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::encode_address(uint32_t address, char *address_bytes)
+{
+    for(int i = 0; i < EEPROM_ADDRESS_BYTES; i++)
     {
-        _i2c.stop();
+        address_bytes[i] = address >> (8 * (EEPROM_ADDRESS_BYTES - 1 - i));
     }
 
-    _i2c.unlock();
-
-    return EEPROM_OK;
+    return get_device_select(address);
 }
 
-/** Given a 64 byte page size within the EEPROM, determine where data of length data_length
- *  and starting at start_address will cross page boundaries
+/** At the beginning of a read operation the address to read from must be specified. The
+ *  device select code and address bytes are sent in a single transaction which is left
+ *  open, so that the read which follows begins with a repeated start
  * 
- *  @param start_address 2 byte address pointing to the intended start location of the operation
- *                       in memory
- *  @param data_length Amount of data to be written in bytes
- *  @param &boundaries Reference to an integer object to store amount of page boundaries detected
- *  @return Returns a 2-D array of size 16 x 2 containing amount of bytes to be written in the 
- *                  0th dimension and address to be written to in the 1st dimension
- */ 
-STM24256::Array_16x2 STM24256::get_array_slice_locs(uint16_t start_address, int data_length, int &boundaries) 
+ * @param address Address pointing to where the operation will begin
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_operation_address(uint32_t address)
 {
-    static int chunks[16][2] = {0};
-
-    int current_page = -1;
-    int end_page = ((start_address + data_length) - 1) / 64; 
+    char address_bytes[EEPROM_ADDRESS_BYTES];
 
-    uint16_t chunk_start_address = start_address;
-    int chunk_index = 0;
+    int device_select = encode_address(address, address_bytes);
 
-    for(uint16_t address = start_address; address < start_address + data_length; address++) 
+    if(_i2c.write(device_select, address_bytes, EEPROM_ADDRESS_BYTES, true) != 0)
     {
-        int byte_page = address / 64;
-
-        if(current_page == -1) 
-        {
-            current_page = byte_page;
-        }
-        else if(current_page != byte_page) 
-        {
-            chunks[chunk_index][LENGTH_DIM] = address - chunk_start_address;
-            chunks[chunk_index][ADDRESS_DIM] = chunk_start_address;
-
-            current_page = byte_page;
-            chunk_start_address = address;
-            chunk_index++;
-            boundaries++;
-        }
-        
-        if(current_page == end_page)
-        {
-            chunks[chunk_index][LENGTH_DIM] = (start_address + data_length) - chunk_start_address; 
-            chunks[chunk_index][ADDRESS_DIM] = chunk_start_address;
-            break;
-        }
+        /** Release the bus, which has been left without a stop condition
+         */
+        _i2c.stop();
+        return EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY;
     }
 
-    return chunks;
+    return EEPROM_OK;
 }
 
-/** Read data_length bytes from address into data
+/** Address the EEPROM and read data_length bytes from it, retrying according to the
+ *  retry policy. If address is where the EEPROM's internal address counter is known to
+ *  point, the address phase is skipped and a current address read is performed
  * 
- * @param address 2 byte address that points to start of data
+ * @param address Address that points to start of data
  * @param data Char array in which to store retrieved data
  * @param data_length Amount of data to retrieve in bytes
  * @return Indicates success or failure reason
  */
-STM24256::EEPROM_Status_t STM24256::read_from_address(uint16_t address, char *data, int data_length)
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::read_chunk(uint32_t address, char *data, int data_length)
 {
-    /** Do not attempt to read zero bytes
+    EEPROM_Status_t status = EEPROM_OK;
+
+    /** Split reads that cross into another bank, which must be addressed afresh
      */
-    if(data_length <= 0)
+    int bank_remaining = EEPROM_BANK_SIZE - (address % EEPROM_BANK_SIZE);
+    if(EEPROM_BANK_COUNT > 1 && data_length > bank_remaining)
     {
-        return EEPROM_DATA_LENGTH_ZERO;
+        status = read_chunk(address, data, bank_remaining);
+        if(status != EEPROM_OK)
+        {
+            return status;
+        }
+
+        return read_chunk(address + bank_remaining, &data[bank_remaining], data_length - bank_remaining);
     }
 
-    /** Limit maximum read size to 1 kB
-     */ 
-    if(data_length > 1024)
+    /** The EEPROM does not respond to reads during a write cycle, wait for it rather than
+     *  consuming retries
+     */
+    status = wait_for_write_cycle();
+    if(status != EEPROM_OK)
     {
-        return EEPROM_DATA_LENGTH_TOO_LONG;
+        return status;
     }
 
-    _i2c.lock();
+    int delay_us = _retry_policy.delay_us;
 
-    /** Determine whether or not we need to do a multi-page read or not
-     */
-    int boundaries = 0;
-    STM24256::Array_16x2 slice_locs = get_array_slice_locs(address, data_length, boundaries);
+    Timer timer;
+    timer.start();
 
-    /** Single page read
-     */
-    if(boundaries == 0) 
+    for(int attempt = 1; ; attempt++)
     {
-        EEPROM_Status_t status = set_operation_address(address, true);
-        if(status != EEPROM_OK)
+        _retry_stats.attempts++;
+
+        bus_lock();
+
+        /** A read continuing where the previous one stopped does not need to re-send the
+         *  address, the EEPROM's address counter already points at it
+         */
+        status = EEPROM_OK;
+        if((int)address != _address_counter)
         {
-            _i2c.unlock();
-            return status;
+            status = set_operation_address(address);
         }
 
-        for(uint8_t attempt = 1; attempt < 4; attempt++)
+        if(status == EEPROM_OK)
         {
-            int read_ack = _i2c.read(EEPROM_MEM_ARRAY_ADDRESS_READ, data, data_length);
-
-            if(read_ack == mbed::I2C::NoACK)
+            if(_i2c.read(get_device_select(address) | 1, data, data_length) == 0)
             {
                 break;
             }
-            else if(read_ack != mbed::I2C::NoACK && attempt == 3) 
-            {
-                _i2c.unlock();
-                return EEPROM_READ_FAIL;
-            }
 
-            wait_us(10000);
+            status = EEPROM_READ_FAIL;
         }
-        
-    }
-    /** Multi-page read
-     */
-    else 
-    {
-        int start_idx = 0;
 
-        /** Each boundary represents a new page within the EEPROM we need to write to
-         *  and each individual page requires the operation address to be reset to
-         *  the new address
+        /** The address counter cannot be relied upon after a failed transaction
          */
-        for(int boundary = 0; boundary <= boundaries; boundary++)
-        {
-            uint16_t address = slice_locs[boundary][ADDRESS_DIM];
+        _address_counter = -1;
 
-            EEPROM_Status_t status = set_operation_address(address, true);
-            if(status != EEPROM_OK)
-            {
-                _i2c.unlock();
-                return status;
-            }
+        /** Other devices may use the bus while we back off
+         */
+        bus_unlock();
 
-            /** Determine array indices we need to write
-             */
+        bool attempts_exhausted = _retry_policy.max_attempts > 0 && attempt >= _retry_policy.max_attempts;
+        bool deadline_passed = _retry_policy.deadline_us > 0 && timer.read_us() >= _retry_policy.deadline_us;
 
-            if(boundary == 0) 
-            {
-                start_idx = 0;
-            }
-            else
-            {
-                start_idx += slice_locs[boundary - 1][LENGTH_DIM]; 
-            }
+        if(attempts_exhausted || deadline_passed)
+        {
+            _retry_stats.failures++;
+            return status;
+        }
 
-            /** Read data chunk
-             */
-            for(uint8_t attempt = 1; attempt < 4; attempt++)
-            {
-                int read_ack = _i2c.read(EEPROM_MEM_ARRAY_ADDRESS_READ, &data[start_idx], slice_locs[boundary][LENGTH_DIM]);
+        int backoff_start_us = timer.read_us();
 
-                if(read_ack == mbed::I2C::NoACK)
-                {
-                    break;
-                }
-                else if(read_ack != mbed::I2C::NoACK && attempt == 3) 
-                {
-                    _i2c.unlock();
-                    return EEPROM_READ_FAIL;
-                }
+        int remaining_us = -1;
+        if(_retry_policy.deadline_us > 0)
+        {
+            remaining_us = _retry_policy.deadline_us - backoff_start_us;
+        }
 
-                wait_us(10000);
-            }
+        retry_backoff(delay_us, remaining_us);
 
-            /** There must be a minimum of 5 ms delay between EEPROM operations due to the time taken by
-             *  the internal processes of the chip. Without this delay, the subsequent write operations 
-             *  will fail sporadically
-             */
-            if(boundary != boundaries) 
-            {
-                wait_us(5000);
-            }
-        }
+        _retry_stats.retries++;
+        _retry_stats.backoff_us += timer.read_us() - backoff_start_us;
+    }
+
+    /** The address counter rolls over from the last byte of the memory array to the first.
+     *  At the end of a bank it must not be relied upon, the next bank is addressed afresh
+     */
+    _address_counter = (address + data_length) % EEPROM_MEM_ARRAY_SIZE;
+    if(EEPROM_BANK_COUNT > 1 && (address + data_length) % EEPROM_BANK_SIZE == 0)
+    {
+        _address_counter = -1;
     }
-    
-    _i2c.unlock();
+
+    bus_unlock();
 
     return EEPROM_OK;
 }
 
-/** Write data_length bytes from char to address, option to verify this write
- *  by reading and checking the data byte by byte
+/** Wait between two attempts at a read according to the retry policy
+ * 
+ * @param &delay_us Reference to the current backoff delay, updated for the next attempt
+ * @param remaining_us Time left before the retry policy deadline, or -1 if there is none
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::retry_backoff(int &delay_us, int remaining_us)
+{
+    if(_retry_policy.mode == EEPROM_RETRY_ACK_POLL)
+    {
+        /** Retry as soon as the EEPROM is ready, whether or not it becomes ready in time is
+         *  determined by the next attempt
+         */
+        int elapsed_us = 0;
+        poll_device_select(remaining_us >= 0 ? remaining_us : _write_cycle_timeout_us, elapsed_us);
+        return;
+    }
+
+    int wait_time_us = delay_us;
+    if(remaining_us >= 0 && wait_time_us > remaining_us)
+    {
+        wait_time_us = remaining_us;
+    }
+
+    wait_us(wait_time_us);
+
+    if(_retry_policy.mode == EEPROM_RETRY_EXPONENTIAL)
+    {
+        delay_us *= 2;
+        if(delay_us > _retry_policy.max_delay_us)
+        {
+            delay_us = _retry_policy.max_delay_us;
+        }
+    }
+}
+
+/** Program up to one page of data in a single I2C transaction; the address bytes and
+ *  data are clocked out back to back, followed by a stop condition which begins the
+ *  EEPROM's internal write cycle
  * 
- * @param address 2 byte address pointing to where the write operation will begin
+ * @param address Address pointing to where the write operation will begin
  * @param data Char array storing data to be written
- * @param data_length Amount of data to write in bytes
- * @param verify Decide whether or not you want to verify the data that has been written
- *               to the EEPROM. Defaults to true
+ * @param data_length Amount of data to write in bytes, must not cross a page boundary
  * @return Indicates success or failure reason
  */
-STM24256::EEPROM_Status_t STM24256::write_to_address(uint16_t address, char *data, int data_length, bool verify)
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::write_page(uint32_t address, const char *data, int data_length)
 {
-    /** Do not attempt to write zero bytes
+    char frame[EEPROM_ADDRESS_BYTES + EEPROM_PAGE_SIZE];
+
+    /** Page writes roll the address counter over within the page, so rather than track
+     *  this we treat the counter as unknown until the next addressed read
      */
-    if(data_length <= 0)
+    _address_counter = -1;
+
+    int device_select = encode_address(address, frame);
+    memcpy(&frame[EEPROM_ADDRESS_BYTES], data, data_length);
+
+    if(_i2c.write(device_select, frame, data_length + EEPROM_ADDRESS_BYTES) != 0)
     {
-        return EEPROM_DATA_LENGTH_ZERO;
+        /** Part of the page may have been programmed, so it can no longer be served from cache
+         */
+        discard_cached(address, data_length);
+
+        return EEPROM_WRITE_FAIL;
     }
 
-    /** Limit maximum write size to 1 kB
-     */ 
-    if(data_length > 1024)
+    _write_cycle_pending = true;
+
+    if(_read_cache != NULL)
     {
-        return EEPROM_DATA_LENGTH_TOO_LONG;
+        _read_cache->update(address, data, data_length);
     }
 
-    /** The EEPROM will pad single-byte values, this will result in potentially reading
-     *  back 'incorrect' values due to padding. To avoid this we can force the user to pad
-     *  the data, i.e. using a uint16_t instead of uint8_t and avoid this issue
+    /** Keep any prefetched copy of the written data up to date
      */
-    if(data_length % 2 != 0) 
+    int overlap_start = (int)address > _read_ahead_address ? address : _read_ahead_address;
+    int overlap_end = (int)address + data_length < _read_ahead_address + _read_ahead_length ? 
+                      address + data_length : _read_ahead_address + _read_ahead_length;
+
+    if(overlap_start < overlap_end)
     {
-        return EEPROM_DATA_LENGTH_ODD;
+        memcpy(&_read_ahead_buffer[overlap_start - _read_ahead_address], &data[overlap_start - address], 
+               overlap_end - overlap_start);
     }
 
-    _i2c.lock();
-
-    enable_write();
+    return EEPROM_OK;
+}
 
-    /** Determine whether or not we need to do a multi-page write or not
-     */
-    int boundaries = 0;
-    STM24256::Array_16x2 slice_locs = get_array_slice_locs(address, data_length, boundaries);
+/** Poll the device select code until the EEPROM acknowledges it, indicating that it is not
+ *  busy with an internal write cycle
+ * 
+ * @param timeout_us Maximum amount of time to poll for in microseconds
+ * @param &elapsed_us Reference to an integer object to store the time taken to acknowledge in
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::poll_device_select(int timeout_us, int &elapsed_us)
+{
+    Timer timer;
+    timer.start();
 
-    /** Single page write
+    /** The EEPROM does not acknowledge its device select code while it is busy programming,
+     *  so we can keep addressing it until it responds rather than sleeping for the worst case.
+     *  The bus is only held for each individual poll, so that other devices on it are not
+     *  starved while the EEPROM is busy
      */
-    if(boundaries == 0) 
+    while(true)
     {
-        EEPROM_Status_t status = set_operation_address(address, false);
-        if(status != EEPROM_OK)
+        bus_lock();
+        _i2c.start();
+        int ack = _i2c.write(_device_select);
+        _i2c.stop();
+        bus_unlock();
+
+        if(ack == mbed::I2C::ACK)
         {
-            _i2c.unlock();
-            return status;
+            elapsed_us = timer.read_us();
+            break;
         }
 
-        for(int i = 0; i < data_length; i++) 
+        if(timer.read_us() >= timeout_us)
         {
-            if(_i2c.write(data[i]) != mbed::I2C::ACK)
-            {
-                disable_write();
-                _i2c.unlock();
-                return EEPROM_WRITE_FAIL;
-            }
+            return EEPROM_WRITE_CYCLE_TIMEOUT;
         }
 
-        _i2c.stop();
+#if MBED_CONF_RTOS_PRESENT
+        rtos::ThisThread::yield();
+#endif
     }
-    /** Multi-page write
-     */
-    else 
+
+    return EEPROM_OK;
+}
+
+/** Poll the device select code until the EEPROM acknowledges it, indicating that the internal
+ *  write cycle of the most recently programmed page has completed, or until the write cycle
+ *  timeout elapses. Returns immediately if no write cycle is in progress
+ * 
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::wait_for_write_cycle()
+{
+    _mutex.lock();
+
+    if(!_write_cycle_pending)
     {
-        int start_idx = 0;
+        _mutex.unlock();
+        return EEPROM_OK;
+    }
 
-        /** Each boundary represents a new page within the EEPROM we need to write to
-         *  and each individual page requires the operation address to be reset to
-         *  the new address
-         */
-        for(int boundary = 0; boundary <= boundaries; boundary++)
-        {       
-            uint16_t address = slice_locs[boundary][ADDRESS_DIM];
+    int elapsed_us = 0;
 
-            EEPROM_Status_t status = set_operation_address(address, false);
-            if(status != EEPROM_OK)
-            {
-                disable_write();
-                _i2c.unlock();
-                return status;
-            }
+    EEPROM_Status_t status = poll_device_select(_write_cycle_timeout_us, elapsed_us);
+    if(status != EEPROM_OK)
+    {
+        _mutex.unlock();
+        return status;
+    }
 
-            /** Determine array indices we need to write
-             */
-            if(boundary == 0) 
-            {
-                start_idx = 0;
-            }
-            else
-            {
-                start_idx += slice_locs[boundary - 1][LENGTH_DIM]; 
-            }
+    _last_write_cycle_us = elapsed_us;
+    _write_cycle_pending = false;
 
-            /** Copy data 'slice' into temp write_data buffer
-             */ 
-            char write_data[64];
-            memcpy(write_data, &data[start_idx], slice_locs[boundary][LENGTH_DIM]);
+    _mutex.unlock();
 
-            /** Write each byte
-             */
-            for(int byte_slice = 0; byte_slice < slice_locs[boundary][LENGTH_DIM]; byte_slice++)
-            {
-                if(_i2c.write(write_data[byte_slice]) != mbed::I2C::ACK)
-                {
-                    disable_write();
-                    _i2c.unlock();
-                    return EEPROM_WRITE_FAIL;
-                }
-            }
+    return EEPROM_OK;
+}
 
-            /** We must create an I2C stop condition on the bus between page write operations
-             */
-            _i2c.stop();
+/** Begin programming up to one page of data without waiting for the EEPROM's internal
+ *  write cycle to complete, so that the write cycles of several EEPROMs may overlap. Any
+ *  write cycle already in progress is waited for first. The data is not verified
+ * 
+ *  Unlike write_to_address, data_length may be odd. The EEPROM programs exactly the bytes
+ *  it is sent and leaves the rest of the page untouched. Layers built on this split their
+ *  writes at page boundaries, so an even write to an odd address arrives here as odd slices
+ * 
+ * @param address Address pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes, must not cross a page boundary
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::program_page(uint32_t address, const char *data, int data_length)
+{
+    EEPROM_Status_t status = check_range_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
 
-            /** There must be a minimum of 5 ms delay between EEPROM operations due to the time taken by
-             *  the internal processes of the chip. Without this delay, the subsequent write operations 
-             *  will fail sporadically
-             */
-            if(boundary != boundaries) 
-            {
-                wait_us(5000);
-            }
-        }
+    if(Page_Slicer(address, data_length).count() > 1)
+    {
+        return EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    if(_async_pending)
+    {
+        _mutex.unlock();
+        return EEPROM_BUSY;
+    }
+
+    status = wait_for_write_cycle();
+    if(status != EEPROM_OK)
+    {
+        _mutex.unlock();
+        return status;
     }
 
+    bus_lock();
+    enable_write();
+
+    status = write_page(address, data, data_length);
+
     disable_write();
-    _i2c.unlock();
+    bus_unlock();
 
-    if(verify) 
+    if(status == EEPROM_OK)
     {
-        /** There must be a minimum of 5 ms delay between EEPROM operations due to the time taken by
-         *  the internal processes of the chip. Without this delay, the subsequent write operations 
-         *  will fail sporadically
-         */
-        wait_us(5000);
+        _write_stats.pages_programmed++;
+    }
 
-        char data_verify[data_length];
+    _mutex.unlock();
 
-        if(read_from_address(address, data_verify, data_length) != EEPROM_OK) 
-        {
-            return EEPROM_READ_FAIL;
-        }
+    return status;
+}
+
+/** Compare data_length bytes at address with data, reading from the EEPROM itself rather
+ *  than from the read cache or read-ahead buffer, both of which already hold data written
+ *  through this driver. Any write cycle in progress is waited for first
+ * 
+ * @param address Address pointing to the start of the data to compare
+ * @param data Char array storing the expected data
+ * @param data_length Amount of data to compare in bytes
+ * @return Returns EEPROM_OK if the EEPROM holds data, EEPROM_VERIFY_FAIL if it does not,
+ *         or another failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::verify_at_address(uint32_t address, const char *data, int data_length)
+{
+    EEPROM_Status_t status = check_range_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
 
-        for(int i = 0; i < data_length; i++)
+    _mutex.lock();
+
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        status = verify_slice(slice, data);
+        if(status != EEPROM_OK)
         {
-            if(data[i] != data_verify[i])
+            if(status == EEPROM_VERIFY_FAIL)
             {
-                return EEPROM_VERIFY_FAIL;
+                discard_cached(address, data_length);
             }
+
+            _mutex.unlock();
+            return status;
         }
     }
 
+    _mutex.unlock();
+
     return EEPROM_OK;
-}
\ No newline at end of file
+}
+
+/** Determine whether or not the internal write cycle of the most recently programmed page
+ *  has completed, polling the device select code once if it is still in progress
+ * 
+ * @return Returns true if the EEPROM is ready to accept another operation
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+bool STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::is_write_cycle_complete()
+{
+    _mutex.lock();
+
+    if(_write_cycle_pending)
+    {
+        int elapsed_us = 0;
+        if(poll_device_select(0, elapsed_us) == EEPROM_OK)
+        {
+            _write_cycle_pending = false;
+        }
+    }
+
+    bool complete = !_write_cycle_pending;
+
+    _mutex.unlock();
+
+    return complete;
+}
+
+/** Read data_length bytes from address into data
+ * 
+ * @param address Address that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::read_from_address(uint32_t address, char *data, int data_length)
+{
+    EEPROM_Status_t status = check_range_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
+
+    /** The bus itself is only held for each transaction, our own mutex ensures that the
+     *  operation as a whole is not interleaved with any other on this EEPROM
+     */
+    _mutex.lock();
+
+    /** Reads that fit within the read cache are served from it where possible, ahead of the
+     *  read-ahead buffer which would otherwise leave the cache without any hits
+     */
+    if(_read_cache != NULL && Page_Slicer(address, data_length).count() <= _read_cache->get_page_count())
+    {
+        status = read_through_cache(address, data, data_length);
+
+        _mutex.unlock();
+
+        return status;
+    }
+
+    /** Short reads are served from the read-ahead buffer where possible
+     */
+    if(_read_ahead_buffer != NULL && data_length < _read_ahead_size)
+    {
+        status = read_through_read_ahead(address, data, data_length);
+
+        _mutex.unlock();
+
+        return status;
+    }
+
+    status = read_range(address, data, data_length);
+
+    _mutex.unlock();
+
+    return status;
+}
+
+/** Write data_length bytes from char to address, option to verify this write
+ *  by reading and checking the data byte by byte
+ * 
+ * @param address Address pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @param verify Decide whether or not you want to verify the data that has been written
+ *               to the EEPROM. Defaults to true
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::write_to_address(uint32_t address, const char *data, int data_length, bool verify)
+{
+    EEPROM_Status_t status = check_write_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
+
+    /** The bus itself is only held for each page write and each poll of the write cycle, our own
+     *  mutex ensures that the operation as a whole is not interleaved with any other on this EEPROM
+     */
+    _mutex.lock();
+
+    /** Do not interleave pages with those of an asynchronous write
+     */
+    if(_async_pending)
+    {
+        _mutex.unlock();
+        return EEPROM_BUSY;
+    }
+
+    enable_write();
+
+    /** Each page within the EEPROM we need to write to requires the operation address to
+     *  be reset to the new address
+     */
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        /** The EEPROM will not accept the next page, nor respond to reads, until its internal
+         *  write cycle has completed, the bus is released while we wait for it
+         */
+        status = wait_for_write_cycle();
+        if(status != EEPROM_OK)
+        {
+            disable_write();
+            _mutex.unlock();
+            return status;
+        }
+
+        if(_write_mode == EEPROM_WRITE_SKIP_UNCHANGED && slice_unchanged(slice, data))
+        {
+            _write_stats.pages_skipped++;
+            continue;
+        }
+
+        /** Write the page slice in a single transaction, the stop condition at the end of which
+         *  starts the internal write cycle
+         */
+        bus_lock();
+        status = write_page(slice.address, &data[slice.offset], slice.length);
+        bus_unlock();
+
+        if(status != EEPROM_OK)
+        {
+            disable_write();
+            _mutex.unlock();
+            return status;
+        }
+
+        _write_stats.pages_programmed++;
+
+        /** Check each page as soon as it has been programmed, rather than once all have been
+         */
+        if(verify && _verify_mode == EEPROM_VERIFY_EACH_PAGE)
+        {
+            status = wait_for_write_cycle();
+            if(status == EEPROM_OK)
+            {
+                status = verify_slice(slice, data);
+            }
+
+            if(status == EEPROM_VERIFY_FAIL)
+            {
+                discard_cached(address, data_length);
+            }
+
+            if(status != EEPROM_OK)
+            {
+                disable_write();
+                _mutex.unlock();
+                return status;
+            }
+        }
+    }
+
+    disable_write();
+
+    if(verify && _verify_mode != EEPROM_VERIFY_EACH_PAGE) 
+    {
+        /** The EEPROM will not respond to the verification read until its internal write cycle
+         *  has completed
+         */
+        status = wait_for_write_cycle();
+        if(status != EEPROM_OK)
+        {
+            _mutex.unlock();
+            return status;
+        }
+
+        if(_verify_mode == EEPROM_VERIFY_CRC)
+        {
+            /** Verification keeps to small chunks, leaving large ones to scan_crc, so that the
+             *  stack used by a write does not grow with EEPROM_SCAN_CHUNK_SIZE
+             */
+            char buffer[2 * EEPROM_VERIFY_CHUNK_SIZE];
+
+            uint32_t crc = 0;
+            status = update_region_crc(address, data_length, crc, buffer, EEPROM_VERIFY_CHUNK_SIZE);
+
+            if(status == EEPROM_OK && crc != STM24256_CRC::crc32(0, data, data_length))
+            {
+                discard_cached(address, data_length);
+                status = EEPROM_VERIFY_FAIL;
+            }
+
+            _mutex.unlock();
+
+            return status;
+        }
+
+        /** Read the data back a page at a time so that stack usage does not grow with the
+         *  length of the write
+         */
+        Page_Slicer verify_slicer(address, data_length);
+
+        while(verify_slicer.next(slice))
+        {
+            status = verify_slice(slice, data);
+            if(status != EEPROM_OK)
+            {
+                if(status == EEPROM_VERIFY_FAIL)
+                {
+                    discard_cached(address, data_length);
+                }
+
+                _mutex.unlock();
+                return status;
+            }
+        }
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_OK;
+}
+
+/** Compute the CRC-32 of a region of the EEPROM. The region is streamed from the EEPROM
+ *  itself, bypassing any read cache, so no buffer needs to be provided
+ * 
+ * @param address Address pointing to the start of the region
+ * @param data_length Length of the region in bytes
+ * @param &crc Reference to a uint32_t in which to store the CRC-32 of the region
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::scan_crc(uint32_t address, int data_length, uint32_t &crc)
+{
+    EEPROM_Status_t status = check_range_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
+
+    /** Two chunks, so that one can be filled while the other is being checksummed
+     */
+    char buffer[2 * EEPROM_SCAN_CHUNK_SIZE];
+
+    _mutex.lock();
+
+    uint32_t region_crc = 0;
+    status = update_region_crc(address, data_length, region_crc, buffer, EEPROM_SCAN_CHUNK_SIZE);
+
+    _mutex.unlock();
+
+    if(status == EEPROM_OK)
+    {
+        crc = region_crc;
+    }
+
+    return status;
+}
+
+/** Select how read_from_address retrieves data that spans more than one page. In
+ *  EEPROM_READ_SEQUENTIAL mode (the default) the whole range is read in a single
+ *  addressed transaction, relying on the EEPROM to auto-increment its address counter
+ *  across page boundaries. EEPROM_READ_PAGED re-addresses the EEPROM for every page
+ * 
+ * @param mode Either EEPROM_READ_SEQUENTIAL or EEPROM_READ_PAGED
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_read_mode(EEPROM_Read_Mode_t mode)
+{
+    _read_mode = mode;
+}
+
+/** Select how write_to_address and write_async program pages. In EEPROM_WRITE_ALWAYS
+ *  mode (the default) every page is programmed. In EEPROM_WRITE_SKIP_UNCHANGED mode each
+ *  page is read first and only programmed if its contents differ from the data being
+ *  written, saving both time and endurance when rewriting mostly unchanged data
+ * 
+ * @param mode Either EEPROM_WRITE_ALWAYS or EEPROM_WRITE_SKIP_UNCHANGED
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_write_mode(EEPROM_Write_Mode_t mode)
+{
+    _write_mode = mode;
+}
+
+/** Select when verified writes read their data back. In EEPROM_VERIFY_AFTER_WRITE mode
+ *  (the default) the data is verified once every page has been programmed. In
+ *  EEPROM_VERIFY_EACH_PAGE mode each page is verified as soon as its write cycle has
+ *  completed, so that a failure is detected before any further pages are programmed.
+ *  EEPROM_VERIFY_CRC compares a CRC-32 of the data with a CRC-32 of the streamed readback
+ *  once every page has been programmed, rather than comparing byte for byte
+ * 
+ * @param mode EEPROM_VERIFY_AFTER_WRITE, EEPROM_VERIFY_EACH_PAGE or EEPROM_VERIFY_CRC
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_verify_mode(EEPROM_Verify_Mode_t mode)
+{
+    _verify_mode = mode;
+}
+
+/** Get the running totals of pages programmed and skipped
+ * 
+ * @param &stats Reference to an EEPROM_Write_Stats_t object to copy the totals into
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::get_write_stats(EEPROM_Write_Stats_t &stats)
+{
+    stats = _write_stats;
+}
+
+/** Reset the pages programmed and skipped totals to zero
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::reset_write_stats()
+{
+    _write_stats.pages_programmed = 0;
+    _write_stats.pages_skipped = 0;
+}
+
+/** Limit the amount of data read from the EEPROM while holding the I2C bus. Longer reads
+ *  are split into transactions of at most max_bytes, and the bus is released between them
+ *  so that other devices on it are not kept waiting for the whole read. The EEPROM's
+ *  address counter is tracked across the split, so each continuation is a current
+ *  address read. This applies in either read mode, in EEPROM_READ_PAGED mode to each page
+ * 
+ * @param max_bytes Maximum amount of data to read per bus transaction, 0 for no limit
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_bus_hold_quantum(int max_bytes)
+{
+    _bus_hold_quantum = max_bytes;
+}
+
+/** Estimate how long the I2C bus is held by this driver for a given percentile of
+ *  transactions. Hold times are recorded in a logarithmic histogram, so the result is
+ *  the upper bound of the bucket in which the percentile falls
+ * 
+ * @param percentile Percentile to report, between 1 and 100. Lower values are taken as 1
+ *                   and higher values as 100
+ * @return Bus hold time in microseconds, or 0 if no transactions have been recorded
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+int STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::get_bus_hold_percentile_us(int percentile)
+{
+    uint32_t total = 0;
+    for(int bucket = 0; bucket < EEPROM_BUS_HOLD_BUCKETS; bucket++)
+    {
+        total += _bus_hold_histogram[bucket];
+    }
+
+    if(total == 0)
+    {
+        return 0;
+    }
+
+    if(percentile < 1)
+    {
+        percentile = 1;
+    }
+    else if(percentile > 100)
+    {
+        percentile = 100;
+    }
+
+    /** Find the first bucket at which the cumulative count reaches the percentile
+     */
+    uint32_t target = ((uint64_t)total * percentile + 99) / 100;
+    uint32_t cumulative = 0;
+
+    for(int bucket = 0; bucket < EEPROM_BUS_HOLD_BUCKETS - 1; bucket++)
+    {
+        cumulative += _bus_hold_histogram[bucket];
+
+        if(cumulative >= target)
+        {
+            return (1 << bucket) < _bus_hold_max_us ? (1 << bucket) : _bus_hold_max_us;
+        }
+    }
+
+    return _bus_hold_max_us;
+}
+
+/** Get the longest time for which the I2C bus has been held by this driver
+ * 
+ * @return Bus hold time in microseconds
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+int STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::get_bus_hold_max_us()
+{
+    return _bus_hold_max_us;
+}
+
+/** Reset all recorded bus hold times
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::reset_bus_hold_stats()
+{
+    memset(_bus_hold_histogram, 0, sizeof(_bus_hold_histogram));
+    _bus_hold_max_us = 0;
+}
+
+/** Replace the policy used to retry failed reads. Defaults to 3 attempts with a fixed
+ *  10 ms delay between them
+ * 
+ * @param policy Retry policy to apply to all subsequent reads
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_retry_policy(const EEPROM_Retry_Policy_t &policy)
+{
+    _retry_policy = policy;
+
+    /** A policy without any limit would retry forever, fall back to a single attempt
+     */
+    if(_retry_policy.max_attempts <= 0 && _retry_policy.deadline_us <= 0)
+    {
+        _retry_policy.max_attempts = 1;
+    }
+}
+
+/** Get the running totals of read attempts, retries, failures and time spent backing off
+ * 
+ * @param &stats Reference to an EEPROM_Retry_Stats_t object to copy the totals into
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::get_retry_stats(EEPROM_Retry_Stats_t &stats)
+{
+    stats = _retry_stats;
+}
+
+/** Reset all read retry totals to zero
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::reset_retry_stats()
+{
+    _retry_stats.attempts = 0;
+    _retry_stats.retries = 0;
+    _retry_stats.failures = 0;
+    _retry_stats.backoff_us = 0;
+}
+
+/** Read data_length bytes from address into data in the current read mode, splitting the
+ *  read into transactions no longer than the bus hold quantum
+ * 
+ * @param address Address that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::read_range(uint32_t address, char *data, int data_length)
+{
+    /** In sequential mode the EEPROM's address counter rolls over page boundaries by itself,
+     *  so the whole range can be retrieved with a single addressed read
+     */
+    if(_read_mode == EEPROM_READ_SEQUENTIAL)
+    {
+        int offset = 0;
+
+        /** Split the read into transactions no longer than the bus hold quantum, each of which
+         *  continues from where the EEPROM's address counter was left by the previous one
+         */
+        while(offset < data_length)
+        {
+            int length = data_length - offset;
+            if(_bus_hold_quantum > 0 && length > _bus_hold_quantum)
+            {
+                length = _bus_hold_quantum;
+            }
+
+            EEPROM_Status_t status = read_chunk(address + offset, &data[offset], length);
+            if(status != EEPROM_OK)
+            {
+                return status;
+            }
+
+            offset += length;
+
+#if MBED_CONF_RTOS_PRESENT
+            if(offset < data_length)
+            {
+                rtos::ThisThread::yield();
+            }
+#endif
+        }
+
+        return EEPROM_OK;
+    }
+
+    /** Each page within the EEPROM we need to read from requires the operation address to
+     *  be reset to the new address. Reads start no write cycle, and read_chunk polls for the end
+     *  of any that is pending, so the pages follow one another without delay
+     */
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        /** Pages longer than the bus hold quantum are split as in sequential mode, the rest of
+         *  the page continuing from the address counter
+         */
+        for(int offset = 0; offset < slice.length; )
+        {
+            int length = slice.length - offset;
+            if(_bus_hold_quantum > 0 && length > _bus_hold_quantum)
+            {
+                length = _bus_hold_quantum;
+            }
+
+            EEPROM_Status_t status = read_chunk(slice.address + offset, &data[slice.offset + offset], length);
+            if(status != EEPROM_OK)
+            {
+                return status;
+            }
+
+            offset += length;
+        }
+    }
+
+    return EEPROM_OK;
+}
+
+/** Read data_length bytes from address into data through the read cache, filling the cache
+ *  with any pages that are not already held
+ * 
+ * @param address Address that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::read_through_cache(uint32_t address, char *data, int data_length)
+{
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        uint32_t page_address = slice.address - (slice.address % EEPROM_PAGE_SIZE);
+
+        char *page = _read_cache->find(page_address);
+        if(page == NULL)
+        {
+            /** Consecutive missing pages continue from the EEPROM's address counter, so only the
+             *  first of them needs to be addressed
+             */
+            page = _read_cache->allocate(page_address);
+
+            EEPROM_Status_t status = read_chunk(page_address, page, EEPROM_PAGE_SIZE);
+            if(status != EEPROM_OK)
+            {
+                _read_cache->invalidate(page_address, EEPROM_PAGE_SIZE);
+                return status;
+            }
+        }
+
+        memcpy(&data[slice.offset], &page[slice.address % EEPROM_PAGE_SIZE], slice.length);
+    }
+
+    return EEPROM_OK;
+}
+
+/** Read data_length bytes from address into data through the read-ahead buffer,
+ *  prefetching if the read continues a sequential access pattern
+ * 
+ * @param address Address that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::read_through_read_ahead(uint32_t address, char *data, int data_length)
+{
+    bool sequential = ((int)address == _read_ahead_next);
+
+    _read_ahead_next = address + data_length;
+
+    /** Serve the read from previously prefetched data if it is all there
+     */
+    if((int)address >= _read_ahead_address && (int)address + data_length <= _read_ahead_address + _read_ahead_length)
+    {
+        memcpy(data, &_read_ahead_buffer[address - _read_ahead_address], data_length);
+        return EEPROM_OK;
+    }
+
+    /** Random access gains nothing from prefetching, so read only what was asked for and
+     *  start the window afresh
+     */
+    if(!sequential)
+    {
+        _read_ahead_window = 0;
+        return read_range(address, data, data_length);
+    }
+
+    /** Grow the window for as long as the sequential pattern holds
+     */
+    if(_read_ahead_window == 0)
+    {
+        _read_ahead_window = 2 * data_length;
+    }
+    else
+    {
+        _read_ahead_window *= 2;
+    }
+
+    if(_read_ahead_window > _read_ahead_size)
+    {
+        _read_ahead_window = _read_ahead_size;
+    }
+
+    int length = _read_ahead_window;
+    if(length < data_length)
+    {
+        length = data_length;
+    }
+
+    if((uint32_t)length > EEPROM_MEM_ARRAY_SIZE - address)
+    {
+        length = EEPROM_MEM_ARRAY_SIZE - address;
+    }
+
+    _read_ahead_length = 0;
+
+    /** The prefetch is subject to the bus hold quantum and read mode like any other read
+     */
+    EEPROM_Status_t status = read_range(address, _read_ahead_buffer, length);
+    if(status != EEPROM_OK)
+    {
+        _read_ahead_window = 0;
+        return status;
+    }
+
+    _read_ahead_address = address;
+    _read_ahead_length = length;
+
+    memcpy(data, _read_ahead_buffer, data_length);
+
+    return EEPROM_OK;
+}
+
+/** Ensure that data_length bytes at address lie within the memory array
+ * 
+ * @param address Address pointing to the start of the data
+ * @param data_length Amount of data in bytes
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::check_range_args(uint32_t address, int data_length)
+{
+    /** Do not attempt to access zero bytes
+     */
+    if(data_length <= 0)
+    {
+        return EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    /** Do not attempt to access beyond the end of the memory array
+     */ 
+    if(address >= EEPROM_MEM_ARRAY_SIZE || (uint32_t)data_length > EEPROM_MEM_ARRAY_SIZE - address)
+    {
+        return EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    return EEPROM_OK;
+}
+
+/** Ensure that a write of data_length bytes to address is within the constraints of
+ *  the EEPROM
+ * 
+ * @param address Address pointing to where the write operation will begin
+ * @param data_length Amount of data to write in bytes
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::check_write_args(uint32_t address, int data_length)
+{
+    EEPROM_Status_t status = check_range_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
+
+    /** The EEPROM will pad single-byte values, this will result in potentially reading
+     *  back 'incorrect' values due to padding. To avoid this we can force the user to pad
+     *  the data, i.e. using a uint16_t instead of uint8_t and avoid this issue
+     */
+    if(data_length % 2 != 0) 
+    {
+        return EEPROM_DATA_LENGTH_ODD;
+    }
+
+    return EEPROM_OK;
+}
+
+/** Stream a region of the EEPROM, continuing a CRC-32 over its contents. The region is read
+ *  in transactions of chunk_size, or of the bus hold quantum if that is smaller, each
+ *  continuing from the EEPROM's address counter. Where asynchronous I2C is available, each
+ *  chunk is checksummed while the next is being transferred
+ * 
+ * @param address Address pointing to the start of the region
+ * @param data_length Length of the region in bytes
+ * @param &crc Reference to the CRC-32 of the preceding data, updated on success
+ * @param buffer Char array of 2 * chunk_size bytes, one chunk being filled while the other
+ *               is checksummed
+ * @param chunk_size Maximum amount of data to read per transaction
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::update_region_crc(uint32_t address, int data_length, uint32_t &crc, 
+                                                      char *buffer, int chunk_size)
+{
+    char *chunk[2] = {buffer, &buffer[chunk_size]};
+    uint32_t region_crc = crc;
+
+    /** Respect the bus hold quantum, so a scan does not hold off other devices on the bus
+     */
+    if(_bus_hold_quantum > 0 && chunk_size > _bus_hold_quantum)
+    {
+        chunk_size = _bus_hold_quantum;
+    }
+
+    int current = 0;
+    int current_length = data_length < chunk_size ? data_length : chunk_size;
+
+    if(read_chunk(address, chunk[current], current_length) != EEPROM_OK)
+    {
+        return EEPROM_READ_FAIL;
+    }
+
+    for(int offset = current_length; offset < data_length; offset += current_length)
+    {
+        int next = current ^ 1;
+        int next_length = data_length - offset;
+        if(next_length > chunk_size)
+        {
+            next_length = chunk_size;
+        }
+
+        /** End chunks at bank boundaries, so that each may continue from the address counter
+         */
+        int bank_remaining = EEPROM_BANK_SIZE - ((address + offset) % EEPROM_BANK_SIZE);
+        if(next_length > bank_remaining)
+        {
+            next_length = bank_remaining;
+        }
+
+        bool next_read = false;
+
+#if DEVICE_I2C_ASYNCH
+        /** Continue reading from the EEPROM's address counter in the background while the
+         *  previous chunk is checksummed. Should the transfer not complete, the chunk is read
+         *  again by read_chunk, which re-addresses the EEPROM and applies the retry policy
+         */
+        if(_address_counter == (int)((address + offset) % EEPROM_MEM_ARRAY_SIZE))
+        {
+            _retry_stats.attempts++;
+            _scan_event = 0;
+
+            bus_lock();
+
+            if(_i2c.transfer(get_device_select(address + offset) | 1, NULL, 0, chunk[next], next_length,
+                             callback(this, &STM24xxx::scan_transfer_done), I2C_EVENT_ALL) == 0)
+            {
+                region_crc = STM24256_CRC::crc32(region_crc, chunk[current], current_length);
+
+                while(_scan_event == 0)
+                {
+#if MBED_CONF_RTOS_PRESENT
+                    rtos::ThisThread::yield();
+#endif
+                }
+
+                next_read = _scan_event == I2C_EVENT_TRANSFER_COMPLETE;
+            }
+            else
+            {
+                region_crc = STM24256_CRC::crc32(region_crc, chunk[current], current_length);
+            }
+
+            /** As in read_chunk, the counter must not be relied upon at the end of a bank
+             */
+            _address_counter = next_read ? (address + offset + next_length) % EEPROM_MEM_ARRAY_SIZE : -1;
+            if(EEPROM_BANK_COUNT > 1 && (address + offset + next_length) % EEPROM_BANK_SIZE == 0)
+            {
+                _address_counter = -1;
+            }
+
+            bus_unlock();
+        }
+        else
+#endif
+        {
+            region_crc = STM24256_CRC::crc32(region_crc, chunk[current], current_length);
+        }
+
+        if(!next_read && read_chunk(address + offset, chunk[next], next_length) != EEPROM_OK)
+        {
+            return EEPROM_READ_FAIL;
+        }
+
+        current = next;
+        current_length = next_length;
+    }
+
+    crc = STM24256_CRC::crc32(region_crc, chunk[current], current_length);
+
+    return EEPROM_OK;
+}
+
+#if DEVICE_I2C_ASYNCH
+/** Record the outcome of an asynchronous chunk transfer made by update_region_crc
+ * 
+ * @param event I2C event flags describing how the transfer ended
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::scan_transfer_done(int event)
+{
+    _scan_event = event;
+}
+#endif
+
+/** Drop any copy of data_length bytes at address held by the read cache or read-ahead
+ *  buffer, after a write to them failed and the EEPROM may hold something other than was
+ *  written
+ * 
+ * @param address Address pointing to the start of the data
+ * @param data_length Amount of data in bytes
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::discard_cached(uint32_t address, int data_length)
+{
+    if(_read_cache != NULL)
+    {
+        _read_cache->invalidate(address, data_length);
+    }
+
+    _read_ahead_length = 0;
+}
+
+/** Read back one page slice of a completed write and compare it with the source data,
+ *  EEPROM_VERIFY_CHUNK_SIZE bytes at a time, stopping at the first mismatch
+ * 
+ * @param slice Page slice of the write operation to verify
+ * @param data Char array storing data that was written
+ * @return Indicates success or failure reason
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::verify_slice(const Page_Slice &slice, const char *data)
+{
+    char data_verify[EEPROM_VERIFY_CHUNK_SIZE];
+
+    /** Each chunk after the first continues from the EEPROM's address counter, so reading
+     *  the slice in small pieces costs little more than reading it in one
+     */
+    for(int offset = 0; offset < slice.length; offset += EEPROM_VERIFY_CHUNK_SIZE)
+    {
+        int length = slice.length - offset;
+        if(length > EEPROM_VERIFY_CHUNK_SIZE)
+        {
+            length = EEPROM_VERIFY_CHUNK_SIZE;
+        }
+
+        /** Always read from the EEPROM itself, bypassing the read cache which would simply echo
+         *  back the data that was written
+         */
+        if(read_chunk(slice.address + offset, data_verify, length) != EEPROM_OK) 
+        {
+            return EEPROM_READ_FAIL;
+        }
+
+        if(memcmp(&data[slice.offset + offset], data_verify, length) != 0)
+        {
+            return EEPROM_VERIFY_FAIL;
+        }
+    }
+
+    return EEPROM_OK;
+}
+
+/** Attach a read cache to the driver. Reads of pages held in the cache are served without
+ *  accessing the bus, and writes made through this driver are applied to the cache. Reads
+ *  spanning more pages than the cache holds bypass it
+ * 
+ * @param cache Pointer to the cache to attach, or NULL to detach the current cache
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::attach_read_cache(STM24xxx_Read_Cache<STM24xxx> *cache)
+{
+    _mutex.lock();
+
+    /** The contents of a cache that was not attached may be stale
+     */
+    if(cache != NULL)
+    {
+        cache->invalidate_all();
+    }
+
+    _read_cache = cache;
+
+    _mutex.unlock();
+}
+
+/** Provide a buffer for sequential read-ahead. When consecutive reads continue from where
+ *  the previous read stopped, the driver prefetches beyond the requested data, split only
+ *  by the bus hold quantum and read mode, doubling the amount prefetched each time the
+ *  pattern holds until the buffer is full. Subsequent reads are then served from the
+ *  buffer. Reads at least as long as the buffer, and reads served by an attached read
+ *  cache, are not affected
+ * 
+ * @param buffer Char array to prefetch into, or NULL to disable read-ahead
+ * @param size Size of the buffer in bytes
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_read_ahead_buffer(char *buffer, int size)
+{
+    _mutex.lock();
+
+    _read_ahead_buffer = buffer;
+    _read_ahead_size = buffer != NULL ? size : 0;
+    _read_ahead_length = 0;
+    _read_ahead_window = 0;
+    _read_ahead_next = -1;
+
+    _mutex.unlock();
+}
+
+/** Set the event queue used to drive asynchronous operations. The queue must be dispatched
+ *  by the application, completion callbacks are invoked in the context of that queue
+ * 
+ * @param queue Pointer to the event queue to use
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_event_queue(events::EventQueue *queue)
+{
+    _event_queue = queue;
+}
+
+/** Begin writing data_length bytes from data to address without blocking the caller. Pages
+ *  are programmed from the event queue, which polls for the end of each write cycle
+ *  rather than waiting for it, and on_complete is invoked with the final status once the
+ *  whole operation, including optional verification, has finished. data must remain
+ *  valid until then
+ * 
+ * @param address Address pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @param on_complete Function to invoke with the status of the operation upon completion
+ * @param verify Decide whether or not you want to verify the data that has been written
+ *               to the EEPROM. Defaults to true
+ * @return Indicates whether the operation was started, or the reason it was not.
+ *         on_complete is only invoked if EEPROM_OK is returned. Should the event queue
+ *         run out of room part way through, on_complete receives EEPROM_EVENT_QUEUE_FULL
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+typename STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::EEPROM_Status_t STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::write_async(uint32_t address, const char *data, int data_length, 
+                                                EEPROM_Callback_t on_complete, bool verify)
+{
+    EEPROM_Status_t status = check_write_args(address, data_length);
+    if(status != EEPROM_OK)
+    {
+        return status;
+    }
+
+    if(_event_queue == NULL)
+    {
+        return EEPROM_NO_EVENT_QUEUE;
+    }
+
+    /** Another thread may be part way through a write of its own
+     */
+    _mutex.lock();
+
+    if(_async_pending)
+    {
+        _mutex.unlock();
+        return EEPROM_BUSY;
+    }
+
+    _async_address = address;
+    _async_length = data_length;
+    _async_data = data;
+    _async_callback = on_complete;
+    _async_slicer = Page_Slicer(address, data_length);
+    _async_verify_slicer = Page_Slicer(address, data_length);
+    _async_verify = verify;
+    _async_write_cycle = false;
+    _async_pending = true;
+    _async_timer.reset();
+    _async_timer.start();
+
+    if(verify && _verify_mode == EEPROM_VERIFY_CRC)
+    {
+        _async_crc = 0;
+        _async_crc_expected = STM24256_CRC::crc32(0, data, data_length);
+    }
+
+    _async_event = _event_queue->call(callback(this, &STM24xxx::write_async_step));
+    if(_async_event == 0)
+    {
+        _async_timer.stop();
+        _async_pending = false;
+        _mutex.unlock();
+        return EEPROM_EVENT_QUEUE_FULL;
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_OK;
+}
+
+/** Determine whether or not an asynchronous write is still in progress
+ * 
+ * @return Returns true if the callback of an asynchronous write has yet to be invoked
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+bool STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::is_write_async_pending()
+{
+    /** The flag is cleared by the event queue, which may run in another thread
+     */
+    _mutex.lock();
+    bool pending = _async_pending;
+    _mutex.unlock();
+
+    return pending;
+}
+
+/** In EEPROM_WRITE_SKIP_UNCHANGED mode, determine whether a page slice of a write already
+ *  holds the data to be written. Slices that cannot be read are treated as changed
+ * 
+ * @param slice Page slice of the write operation to check
+ * @param data Char array storing data to be written
+ * @return Returns true if programming the slice can be skipped
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+bool STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::slice_unchanged(const Page_Slice &slice, const char *data)
+{
+    return verify_slice(slice, data) == EEPROM_OK;
+}
+
+/** Perform the next step of an asynchronous write; poll for the end of a write cycle,
+ *  program the next page or verify the next page. Called from the event queue
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::write_async_step()
+{
+    /** Held for the whole step, so that a write made by another thread in the meantime is
+     *  seen through _write_cycle_pending rather than a snapshot taken when this write began
+     */
+    _mutex.lock();
+
+    /** While the EEPROM is busy programming a page it does not acknowledge its device select
+     *  code, rather than block until it does, check once and try again later
+     */
+    if(_write_cycle_pending)
+    {
+        bus_lock();
+        _i2c.start();
+        int ack = _i2c.write(_device_select);
+        _i2c.stop();
+        bus_unlock();
+
+        if(ack != mbed::I2C::ACK)
+        {
+            bool timed_out = _async_timer.read_us() >= _write_cycle_timeout_us;
+
+            _mutex.unlock();
+
+            if(timed_out)
+            {
+                write_async_complete(EEPROM_WRITE_CYCLE_TIMEOUT);
+            }
+            else
+            {
+                schedule_write_async_step(1);
+            }
+            return;
+        }
+
+        if(_async_write_cycle)
+        {
+            _last_write_cycle_us = _async_timer.read_us();
+        }
+        _write_cycle_pending = false;
+    }
+
+    /** The page most recently programmed by this write has completed its write cycle
+     */
+    if(_async_write_cycle)
+    {
+        _async_write_cycle = false;
+
+        if(_async_verify && _verify_mode == EEPROM_VERIFY_EACH_PAGE)
+        {
+            EEPROM_Status_t status = verify_slice(_async_last_slice, _async_data);
+            if(status != EEPROM_OK)
+            {
+                _mutex.unlock();
+                write_async_complete(status);
+                return;
+            }
+        }
+    }
+
+    Page_Slice slice;
+
+    /** Program the next page, then come back once its write cycle is likely to have finished
+     */
+    if(_async_slicer.next(slice))
+    {
+        if(_write_mode == EEPROM_WRITE_SKIP_UNCHANGED && slice_unchanged(slice, _async_data))
+        {
+            _write_stats.pages_skipped++;
+            _mutex.unlock();
+
+            schedule_write_async_step(0);
+            return;
+        }
+
+        bus_lock();
+        enable_write();
+
+        EEPROM_Status_t status = write_page(slice.address, &_async_data[slice.offset], slice.length);
+
+        disable_write();
+        bus_unlock();
+
+        if(status != EEPROM_OK)
+        {
+            _mutex.unlock();
+            write_async_complete(status);
+            return;
+        }
+
+        _write_stats.pages_programmed++;
+        _async_last_slice = slice;
+        _async_write_cycle = true;
+        _async_timer.reset();
+        _async_timer.start();
+
+        _mutex.unlock();
+
+        schedule_write_async_step(1);
+        return;
+    }
+
+    /** Verify one page per step so that the event queue is not monopolised
+     */
+    if(_async_verify && _verify_mode != EEPROM_VERIFY_EACH_PAGE && _async_verify_slicer.next(slice))
+    {
+        EEPROM_Status_t status;
+        if(_verify_mode == EEPROM_VERIFY_CRC)
+        {
+            char buffer[2 * EEPROM_VERIFY_CHUNK_SIZE];
+            status = update_region_crc(slice.address, slice.length, _async_crc, buffer, EEPROM_VERIFY_CHUNK_SIZE);
+        }
+        else
+        {
+            status = verify_slice(slice, _async_data);
+        }
+
+        _mutex.unlock();
+
+        if(status != EEPROM_OK)
+        {
+            write_async_complete(status);
+            return;
+        }
+
+        schedule_write_async_step(0);
+        return;
+    }
+
+    bool crc_mismatch = _async_verify && _verify_mode == EEPROM_VERIFY_CRC && _async_crc != _async_crc_expected;
+
+    _mutex.unlock();
+
+    write_async_complete(crc_mismatch ? EEPROM_VERIFY_FAIL : EEPROM_OK);
+}
+
+/** Queue the next step of an asynchronous write. If the event queue has no room for it the
+ *  write can make no further progress, so it is concluded with EEPROM_EVENT_QUEUE_FULL
+ * 
+ * @param delay_ms Delay before the step is performed in milliseconds, or 0 to perform it
+ *                 as soon as possible
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::schedule_write_async_step(int delay_ms)
+{
+    /** The event is recorded so that the destructor can cancel it
+     */
+    _mutex.lock();
+
+    if(delay_ms > 0)
+    {
+        _async_event = _event_queue->call_in(delay_ms, callback(this, &STM24xxx::write_async_step));
+    }
+    else
+    {
+        _async_event = _event_queue->call(callback(this, &STM24xxx::write_async_step));
+    }
+
+    int id = _async_event;
+
+    _mutex.unlock();
+
+    if(id == 0)
+    {
+        write_async_complete(EEPROM_EVENT_QUEUE_FULL);
+    }
+}
+
+/** Conclude an asynchronous write and notify the caller of its status
+ * 
+ * @param status Final status of the asynchronous write
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::write_async_complete(EEPROM_Status_t status)
+{
+    _mutex.lock();
+
+    _async_timer.stop();
+    _async_pending = false;
+
+    /** Whichever step of the write failed verification, the pages it programmed may not hold
+     *  what was written
+     */
+    if(status == EEPROM_VERIFY_FAIL)
+    {
+        discard_cached(_async_address, _async_length);
+    }
+
+    EEPROM_Callback_t on_complete = _async_callback;
+
+    _mutex.unlock();
+
+    if(on_complete)
+    {
+        on_complete(status);
+    }
+}
+
+/** Set the maximum amount of time to wait for the EEPROM to complete its internal write cycle
+ *  before an operation is abandoned
+ * 
+ * @param timeout_us Write cycle ceiling in microseconds
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+void STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::set_write_cycle_timeout_us(int timeout_us)
+{
+    _write_cycle_timeout_us = timeout_us;
+}
+
+/** Get the duration of the most recently measured internal write cycle
+ * 
+ * @return Time in microseconds between the end of a page write and the EEPROM acknowledging
+ *         its device select code again
+ */
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+int STM24xxx<PAGE_BYTES, ARRAY_BYTES, ADDRESS_BYTES>::get_last_write_cycle_us()
+{
+    return _last_write_cycle_us;
+}
+
+/** Parts of the M24xxx family for which the driver is compiled. Further parts can be
+ *  supported by adding their geometry here and to each layer built upon the driver
+ */
+template class STM24xxx<32, 8192, 2>;
+template class STM24xxx<64, 32768, 2>;
+template class STM24xxx<128, 65536, 2>;
+template class STM24xxx<256, 131072, 2>;
+template class STM24xxx<256, 262144, 2>;
@@ -1,6 +1,6 @@
 /**
   * @file    STM24256.h
-  * @version 1.2.2
+  * @version 2.4.1
   * @author  Adam Mitchell
   * @brief   Header file of the STM24256 EEPROM driver module
   */
@@ -13,19 +13,69 @@
  */
 #include <mbed.h>
 
-/** 8-bit I2C address for the EEPROM memory array. This should be set according to the 
- *  configuration of the hardware address pins
+/** 8-bit device select code for the EEPROM memory array with all hardware address pins tied
+ *  low, for a write. The configuration of the address pins is given to the constructor, and
+ *  reads set the R/W bit, bit 0, of the device select code
  */
-#define EEPROM_MEM_ARRAY_ADDRESS_READ 0b10100001
 #define EEPROM_MEM_ARRAY_ADDRESS_WRITE 0b10100000
 
-/** Base class for the STM24256 series EEPROM 
+/** Amount of data read back and compared at a time when verifying a write
+ */
+#define EEPROM_VERIFY_CHUNK_SIZE 16
+
+/** Amount of data read in a single transaction by scan_crc, unless a smaller bus hold quantum
+ *  is set. Two buffers of this size are placed on the stack of scan_crc so that one can be
+ *  filled while the other is being checksummed. Writes verified by CRC read in chunks of
+ *  EEPROM_VERIFY_CHUNK_SIZE instead. May be defined by the application, trading stack for
+ *  fewer transactions per scan
+ */
+#ifndef EEPROM_SCAN_CHUNK_SIZE
+#define EEPROM_SCAN_CHUNK_SIZE 512
+#endif
+
+/** Amount of logarithmic buckets in the bus hold time histogram, bucket n holds times
+ *  of less than 2^n microseconds
+ */
+#define EEPROM_BUS_HOLD_BUCKETS 24
+
+/** Forward declaration of the optional read cache
+ */
+template<class EEPROM_Type> class STM24xxx_Read_Cache;
+
+/** Base class for the M24xxx series EEPROMs. The geometry of the part is fixed at compile
+ *  time so that page splitting and bounds checks reduce to constant arithmetic
+ * 
+ * @tparam PAGE_BYTES Size of a single page in bytes, must be a power of two
+ * @tparam ARRAY_BYTES Size of the whole memory array in bytes
+ * @tparam ADDRESS_BYTES Amount of address bytes sent to select a location in the memory array
  */ 
-class STM24256 
+template<int PAGE_BYTES, int ARRAY_BYTES, int ADDRESS_BYTES>
+class STM24xxx 
 {
 
+    static_assert(PAGE_BYTES > 0 && (PAGE_BYTES & (PAGE_BYTES - 1)) == 0, "Page size must be a power of two");
+    static_assert(ARRAY_BYTES % PAGE_BYTES == 0, "Memory array must hold a whole number of pages");
+    static_assert(ADDRESS_BYTES == 1 || ADDRESS_BYTES == 2, "Parts are addressed with 1 or 2 address bytes");
+    static_assert(ARRAY_BYTES <= (8 << (8 * ADDRESS_BYTES)), "Memory array must be addressable by the address bytes and 3 device select bits");
+
     public:
 
+        /** Size of a single page and of the whole memory array in bytes, and the amount of
+         *  address bytes which select a location within the memory array
+         */
+        static constexpr int EEPROM_PAGE_SIZE = PAGE_BYTES;
+        static constexpr int EEPROM_MEM_ARRAY_SIZE = ARRAY_BYTES;
+        static constexpr int EEPROM_ADDRESS_BYTES = ADDRESS_BYTES;
+
+        /** Parts larger than the address bytes can select are divided into banks, chosen by the
+         *  low bits of the device select code in place of address pins. Sequential reads do not
+         *  continue from one bank into the next, so reads are split at bank boundaries
+         */
+        static constexpr int EEPROM_BANK_SIZE = ARRAY_BYTES < (1 << (8 * ADDRESS_BYTES)) ? ARRAY_BYTES : (1 << (8 * ADDRESS_BYTES));
+        static constexpr int EEPROM_BANK_COUNT = ARRAY_BYTES / EEPROM_BANK_SIZE;
+
+        static_assert((EEPROM_BANK_COUNT & (EEPROM_BANK_COUNT - 1)) == 0, "Memory array must hold a power of two banks");
+
         typedef int EEPROM_Status_t;
 
         enum 
@@ -39,7 +89,179 @@ class STM24256
             EEPROM_VERIFY_FAIL                   = 6,
             EEPROM_DATA_LENGTH_ODD               = 7,
             EEPROM_DATA_LENGTH_ZERO              = 8,
-            EEPROM_DATA_LENGTH_TOO_LONG          = 9
+            EEPROM_DATA_LENGTH_TOO_LONG          = 9,
+            EEPROM_WRITE_CYCLE_TIMEOUT           = 10,
+            EEPROM_BUSY                          = 11,
+            EEPROM_NO_EVENT_QUEUE                = 12,
+            EEPROM_EVENT_QUEUE_FULL              = 13
+        };
+
+        /** Callback invoked with the final status of an asynchronous operation
+         */
+        typedef mbed::Callback<void(EEPROM_Status_t)> EEPROM_Callback_t;
+
+        typedef int EEPROM_Read_Mode_t;
+
+        enum
+        {
+            EEPROM_READ_SEQUENTIAL = 0,
+            EEPROM_READ_PAGED      = 1
+        };
+
+        typedef int EEPROM_Write_Mode_t;
+
+        enum
+        {
+            EEPROM_WRITE_ALWAYS          = 0,
+            EEPROM_WRITE_SKIP_UNCHANGED  = 1
+        };
+
+        typedef int EEPROM_Verify_Mode_t;
+
+        enum
+        {
+            EEPROM_VERIFY_AFTER_WRITE = 0,
+            EEPROM_VERIFY_EACH_PAGE   = 1,
+            EEPROM_VERIFY_CRC         = 2
+        };
+
+        /** Running totals of pages programmed and pages left alone because their contents
+         *  already matched the data being written
+         */
+        typedef struct
+        {
+            uint32_t pages_programmed;
+            uint32_t pages_skipped;
+        } EEPROM_Write_Stats_t;
+
+        typedef int EEPROM_Retry_Mode_t;
+
+        enum
+        {
+            EEPROM_RETRY_FIXED       = 0,
+            EEPROM_RETRY_EXPONENTIAL = 1,
+            EEPROM_RETRY_ACK_POLL    = 2
+        };
+
+        /** Determines how a failed read is retried. A read is abandoned once max_attempts have been
+         *  made or deadline_us has elapsed since the first attempt, whichever comes first; a value
+         *  of zero disables that limit, but at least one of the two must be set
+         * 
+         *  EEPROM_RETRY_FIXED waits delay_us between attempts
+         *  EEPROM_RETRY_EXPONENTIAL waits delay_us, doubling after each attempt up to max_delay_us
+         *  EEPROM_RETRY_ACK_POLL addresses the EEPROM until it acknowledges, then retries immediately
+         */
+        typedef struct
+        {
+            EEPROM_Retry_Mode_t mode;
+            int max_attempts;
+            int delay_us;
+            int max_delay_us;
+            int deadline_us;
+        } EEPROM_Retry_Policy_t;
+
+        /** Running totals describing how reads have been retried
+         */
+        typedef struct
+        {
+            uint32_t attempts;
+            uint32_t retries;
+            uint32_t failures;
+            uint32_t backoff_us;
+        } EEPROM_Retry_Stats_t;
+
+        /** A contiguous chunk of a read or write operation that lies within a single page
+         */
+        typedef struct
+        {
+            uint32_t address;
+            int length;
+            int offset;
+        } Page_Slice;
+
+        /** Lazily splits an operation of arbitrary length into page-aligned chunks, one at a
+         *  time, so that no fixed-size table of chunks is required. Each chunk is computed
+         *  arithmetically and all state lives in the Page_Slicer object itself, so slicers are
+         *  reentrant and may be evaluated at compile time when the address and length are constant
+         */
+        class Page_Slicer
+        {
+            public:
+
+                /** Begin slicing data_length bytes starting at start_address into page-aligned chunks
+                 * 
+                 * @param start_address Address pointing to the intended start location of the operation
+                 *                      in memory
+                 * @param data_length Amount of data to be sliced in bytes
+                 */
+                constexpr Page_Slicer(uint32_t start_address, int data_length) :
+                                      _address(start_address),
+                                      _offset(0),
+                                      _remaining(data_length)
+                {
+
+                }
+
+                /** Produce the next chunk of the operation, which will not cross a page boundary
+                 * 
+                 * @param &slice Reference to a Page_Slice object to store the address, length and buffer offset
+                 *               of the chunk in
+                 * @return Returns true if a chunk was produced, false if the whole operation has been sliced
+                 */
+                constexpr bool next(Page_Slice &slice)
+                {
+                    if(_remaining <= 0)
+                    {
+                        return false;
+                    }
+
+                    int length = EEPROM_PAGE_SIZE - (_address % EEPROM_PAGE_SIZE);
+                    if(length > _remaining)
+                    {
+                        length = _remaining;
+                    }
+
+                    slice.address = _address;
+                    slice.length = length;
+                    slice.offset = _offset;
+
+                    _address += length;
+                    _offset += length;
+                    _remaining -= length;
+
+                    return true;
+                }
+
+                /** Determine whether or not the most recently produced chunk was the last in the operation
+                 * 
+                 * @return Returns true if there are no more chunks to produce
+                 */
+                constexpr bool done() const
+                {
+                    return _remaining <= 0;
+                }
+
+                /** Determine how many chunks remain to be produced, without producing them
+                 * 
+                 * @return Amount of page-aligned chunks remaining in the operation
+                 */
+                constexpr int count() const
+                {
+                    if(_remaining <= 0)
+                    {
+                        return 0;
+                    }
+
+                    return ((_address % EEPROM_PAGE_SIZE) + _remaining + EEPROM_PAGE_SIZE - 1) / EEPROM_PAGE_SIZE;
+                }
+
+            private:
+
+                uint32_t _address;
+
+                int _offset;
+
+                int _remaining;
         };
 
         /** Constructor. Create an EEPROM interface, connected to the pins specified 
@@ -49,33 +271,242 @@ class STM24256
          * @param sda I2C data line pin
          * @param scl I2C clock line pin
          * @param frequency_hz The bus frequency in hertz
+         * @param address_pins Levels of the E2, E1 and E0 address pins as bits 2, 1 and 0, so that
+         *                     several EEPROMs may share a bus. Pins that a part uses to select a
+         *                     bank are ignored. Defaults to all pins tied low
          */
-        STM24256(PinName write_control, PinName sda, PinName scl, int frequency_hz);
+        STM24xxx(PinName write_control, PinName sda, PinName scl, int frequency_hz, int address_pins = 0);
 
-        /** Destructor. Will disable write_control
+        /** Destructor. Will disable write_control and cancel the queued step of any asynchronous
+         *  write still in progress, without invoking its callback. A step already being performed
+         *  by the event queue holds this driver, so the driver must outlive it
          */
-        ~STM24256();
+        ~STM24xxx();
 
         /** Read data_length bytes from address into data
          * 
-         * @param address 2 byte address that points to start of data
+         * @param address Address that points to start of data
          * @param data Char array in which to store retrieved data
          * @param data_length Amount of data to retrieve in bytes
          * @return Indicates success or failure reason
          */
-        EEPROM_Status_t read_from_address(uint16_t address, char *data, int data_length);
+        EEPROM_Status_t read_from_address(uint32_t address, char *data, int data_length);
 
         /** Write data_length bytes from char to address, option to verify this write
          *  by reading and checking the data byte by byte
          * 
-         * @param address 2 byte address pointing to where the write operation will begin
+         * @param address Address pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes
+         * @param verify Decide whether or not you want to verify the data that has been written
+         *               to the EEPROM. Defaults to true
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t write_to_address(uint32_t address, const char *data, int data_length, bool verify = true);
+
+        /** Attach a read cache to the driver. Reads of pages held in the cache are served without
+         *  accessing the bus, and writes made through this driver are applied to the cache. Reads
+         *  spanning more pages than the cache holds bypass it
+         * 
+         * @param cache Pointer to the cache to attach, or NULL to detach the current cache
+         */
+        void attach_read_cache(STM24xxx_Read_Cache<STM24xxx> *cache);
+
+        /** Provide a buffer for sequential read-ahead. When consecutive reads continue from where
+         *  the previous read stopped, the driver prefetches beyond the requested data, split only
+         *  by the bus hold quantum and read mode, doubling the amount prefetched each time the
+         *  pattern holds until the buffer is full. Subsequent reads are then served from the
+         *  buffer. Reads at least as long as the buffer, and reads served by an attached read
+         *  cache, are not affected
+         * 
+         * @param buffer Char array to prefetch into, or NULL to disable read-ahead
+         * @param size Size of the buffer in bytes
+         */
+        void set_read_ahead_buffer(char *buffer, int size);
+
+        /** Set the event queue used to drive asynchronous operations. The queue must be dispatched
+         *  by the application, completion callbacks are invoked in the context of that queue
+         * 
+         * @param queue Pointer to the event queue to use
+         */
+        void set_event_queue(events::EventQueue *queue);
+
+        /** Begin writing data_length bytes from data to address without blocking the caller. Pages
+         *  are programmed from the event queue, which polls for the end of each write cycle
+         *  rather than waiting for it, and on_complete is invoked with the final status once the
+         *  whole operation, including optional verification, has finished. data must remain
+         *  valid until then
+         * 
+         * @param address Address pointing to where the write operation will begin
          * @param data Char array storing data to be written
          * @param data_length Amount of data to write in bytes
+         * @param on_complete Function to invoke with the status of the operation upon completion
          * @param verify Decide whether or not you want to verify the data that has been written
          *               to the EEPROM. Defaults to true
+         * @return Indicates whether the operation was started, or the reason it was not.
+         *         on_complete is only invoked if EEPROM_OK is returned. Should the event queue
+         *         run out of room part way through, on_complete receives EEPROM_EVENT_QUEUE_FULL
+         */
+        EEPROM_Status_t write_async(uint32_t address, const char *data, int data_length, 
+                                    EEPROM_Callback_t on_complete, bool verify = true);
+
+        /** Begin programming up to one page of data without waiting for the EEPROM's internal
+         *  write cycle to complete, so that the write cycles of several EEPROMs may overlap. Any
+         *  write cycle already in progress is waited for first. The data is not verified
+         * 
+         *  Unlike write_to_address, data_length may be odd. The EEPROM programs exactly the bytes
+         *  it is sent and leaves the rest of the page untouched. Layers built on this split their
+         *  writes at page boundaries, so an even write to an odd address arrives here as odd slices
+         * 
+         * @param address Address pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes, must not cross a page boundary
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t program_page(uint32_t address, const char *data, int data_length);
+
+        /** Compare data_length bytes at address with data, reading from the EEPROM itself rather
+         *  than from the read cache or read-ahead buffer, both of which already hold data written
+         *  through this driver. Any write cycle in progress is waited for first
+         * 
+         * @param address Address pointing to the start of the data to compare
+         * @param data Char array storing the expected data
+         * @param data_length Amount of data to compare in bytes
+         * @return Returns EEPROM_OK if the EEPROM holds data, EEPROM_VERIFY_FAIL if it does not,
+         *         or another failure reason
+         */
+        EEPROM_Status_t verify_at_address(uint32_t address, const char *data, int data_length);
+
+        /** Determine whether or not the internal write cycle of the most recently programmed page
+         *  has completed, polling the device select code once if it is still in progress
+         * 
+         * @return Returns true if the EEPROM is ready to accept another operation
+         */
+        bool is_write_cycle_complete();
+
+        /** Poll the device select code until the EEPROM acknowledges it, indicating that the internal
+         *  write cycle of the most recently programmed page has completed, or until the write cycle
+         *  timeout elapses. Returns immediately if no write cycle is in progress
+         * 
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t wait_for_write_cycle();
+
+        /** Determine whether or not an asynchronous write is still in progress
+         * 
+         * @return Returns true if the callback of an asynchronous write has yet to be invoked
+         */
+        bool is_write_async_pending();
+
+        /** Compute the CRC-32 of a region of the EEPROM. The region is streamed from the EEPROM
+         *  itself, bypassing any read cache, so no buffer needs to be provided
+         * 
+         * @param address Address pointing to the start of the region
+         * @param data_length Length of the region in bytes
+         * @param &crc Reference to a uint32_t in which to store the CRC-32 of the region
          * @return Indicates success or failure reason
          */
-        EEPROM_Status_t write_to_address(uint16_t address, char *data, int data_length, bool verify = true);
+        EEPROM_Status_t scan_crc(uint32_t address, int data_length, uint32_t &crc);
+
+        /** Select how read_from_address retrieves data that spans more than one page. In
+         *  EEPROM_READ_SEQUENTIAL mode (the default) the whole range is read in a single
+         *  addressed transaction, relying on the EEPROM to auto-increment its address counter
+         *  across page boundaries. EEPROM_READ_PAGED re-addresses the EEPROM for every page
+         * 
+         * @param mode Either EEPROM_READ_SEQUENTIAL or EEPROM_READ_PAGED
+         */
+        void set_read_mode(EEPROM_Read_Mode_t mode);
+
+        /** Select how write_to_address and write_async program pages. In EEPROM_WRITE_ALWAYS
+         *  mode (the default) every page is programmed. In EEPROM_WRITE_SKIP_UNCHANGED mode each
+         *  page is read first and only programmed if its contents differ from the data being
+         *  written, saving both time and endurance when rewriting mostly unchanged data
+         * 
+         * @param mode Either EEPROM_WRITE_ALWAYS or EEPROM_WRITE_SKIP_UNCHANGED
+         */
+        void set_write_mode(EEPROM_Write_Mode_t mode);
+
+        /** Select when verified writes read their data back. In EEPROM_VERIFY_AFTER_WRITE mode
+         *  (the default) the data is verified once every page has been programmed. In
+         *  EEPROM_VERIFY_EACH_PAGE mode each page is verified as soon as its write cycle has
+         *  completed, so that a failure is detected before any further pages are programmed.
+         *  EEPROM_VERIFY_CRC compares a CRC-32 of the data with a CRC-32 of the streamed readback
+         *  once every page has been programmed, rather than comparing byte for byte
+         * 
+         * @param mode EEPROM_VERIFY_AFTER_WRITE, EEPROM_VERIFY_EACH_PAGE or EEPROM_VERIFY_CRC
+         */
+        void set_verify_mode(EEPROM_Verify_Mode_t mode);
+
+        /** Get the running totals of pages programmed and skipped
+         * 
+         * @param &stats Reference to an EEPROM_Write_Stats_t object to copy the totals into
+         */
+        void get_write_stats(EEPROM_Write_Stats_t &stats);
+
+        /** Reset the pages programmed and skipped totals to zero
+         */
+        void reset_write_stats();
+
+        /** Limit the amount of data read from the EEPROM while holding the I2C bus. Longer reads
+         *  are split into transactions of at most max_bytes, and the bus is released between them
+         *  so that other devices on it are not kept waiting for the whole read. The EEPROM's
+         *  address counter is tracked across the split, so each continuation is a current
+         *  address read. This applies in either read mode, in EEPROM_READ_PAGED mode to each page
+         * 
+         * @param max_bytes Maximum amount of data to read per bus transaction, 0 for no limit
+         */
+        void set_bus_hold_quantum(int max_bytes);
+
+        /** Estimate how long the I2C bus is held by this driver for a given percentile of
+         *  transactions. Hold times are recorded in a logarithmic histogram, so the result is
+         *  the upper bound of the bucket in which the percentile falls
+         * 
+         * @param percentile Percentile to report, between 1 and 100. Lower values are taken as 1
+         *                   and higher values as 100
+         * @return Bus hold time in microseconds, or 0 if no transactions have been recorded
+         */
+        int get_bus_hold_percentile_us(int percentile);
+
+        /** Get the longest time for which the I2C bus has been held by this driver
+         * 
+         * @return Bus hold time in microseconds
+         */
+        int get_bus_hold_max_us();
+
+        /** Reset all recorded bus hold times
+         */
+        void reset_bus_hold_stats();
+
+        /** Replace the policy used to retry failed reads. Defaults to 3 attempts with a fixed
+         *  10 ms delay between them
+         * 
+         * @param policy Retry policy to apply to all subsequent reads
+         */
+        void set_retry_policy(const EEPROM_Retry_Policy_t &policy);
+
+        /** Get the running totals of read attempts, retries, failures and time spent backing off
+         * 
+         * @param &stats Reference to an EEPROM_Retry_Stats_t object to copy the totals into
+         */
+        void get_retry_stats(EEPROM_Retry_Stats_t &stats);
+
+        /** Reset all read retry totals to zero
+         */
+        void reset_retry_stats();
+
+        /** Set the maximum amount of time to wait for the EEPROM to complete its internal write cycle
+         *  before an operation is abandoned
+         * 
+         * @param timeout_us Write cycle ceiling in microseconds
+         */
+        void set_write_cycle_timeout_us(int timeout_us);
+
+        /** Get the duration of the most recently measured internal write cycle
+         * 
+         * @return Time in microseconds between the end of a page write and the EEPROM acknowledging
+         *         its device select code again
+         */
+        int get_last_write_cycle_us();
 
     private:
 
@@ -85,12 +516,6 @@ class STM24256
             EEPROM_WRITE_DISABLE = 1
         };
 
-        enum
-        {
-            LENGTH_DIM  = 0,
-            ADDRESS_DIM = 1
-        };
-
         /** Set EEPROM write_control line to logic low; this allows the EEPROM to enter write mode
          */
         void enable_write();
@@ -99,34 +524,288 @@ class STM24256
          */
         void disable_write();
 
-        /** At the beginning of a read or write operation an address (to either read from, or write to)
-         *  must be specified 
+        /** Take ownership of the I2C bus and begin timing how long it is held for
+         */
+        void bus_lock();
+
+        /** Release the I2C bus and record how long it was held for
+         */
+        void bus_unlock();
+
+        /** Get the device select code, excluding the read bit, for the bank holding an address
          * 
-         * @param address 2 byte address pointing to where the operation will begin
-         * @param send_stop Optionally generate an I2C stop condition on the bus
+         * @param address Address within the memory array
+         * @return The device select code to write to
+         */
+        int get_device_select(uint32_t address);
+
+        /** Encode an address within the memory array as the address bytes that select it
+         * 
+         * @param address Address to encode
+         * @param address_bytes Char array of EEPROM_ADDRESS_BYTES in which to store the address bytes,
+         *                      most significant first
+         * @return The device select code to write to
+         */
+        int encode_address(uint32_t address, char *address_bytes);
+
+        /** At the beginning of a read operation the address to read from must be specified. The
+         *  device select code and address bytes are sent in a single transaction which is left
+         *  open, so that the read which follows begins with a repeated start
+         * 
+         * @param address Address pointing to where the operation will begin
          * @return Indicates success or failure reason
          */ 
-        EEPROM_Status_t set_operation_address(uint16_t address, bool stop);
+        EEPROM_Status_t set_operation_address(uint32_t address);
 
-        /** Data type to handle 2-D array of size 16 x 2
-         */  
-        typedef int (&Array_16x2)[16][2];
+        /** Address the EEPROM and read data_length bytes from it, retrying according to the
+         *  retry policy. If address is where the EEPROM's internal address counter is known to
+         *  point, the address phase is skipped and a current address read is performed
+         * 
+         * @param address Address that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_chunk(uint32_t address, char *data, int data_length);
 
-        /** Given a 64 byte page size within the EEPROM, determine where data of length data_length
-         *  and starting at start_address will cross page boundaries
+        /** Stream a region of the EEPROM, continuing a CRC-32 over its contents. The region is read
+         *  in transactions of chunk_size, or of the bus hold quantum if that is smaller, each
+         *  continuing from the EEPROM's address counter. Where asynchronous I2C is available, each
+         *  chunk is checksummed while the next is being transferred
          * 
-         *  @param start_address 2 byte address pointing to the intended start location of the operation
-         *                       in memory
-         *  @param data_length Amount of data to be written in bytes
-         *  @param &boundaries Reference to an integer object to store amount of page boundaries detected
-         *  @return Returns a 2-D array of size 16 x 2 containing amount of bytes to be written in the 
-         *                  0th dimension and address to be written to in the 1st dimension
-         */ 
-        Array_16x2 get_array_slice_locs(uint16_t start_address, int data_length, int &boundaries);
+         * @param address Address pointing to the start of the region
+         * @param data_length Length of the region in bytes
+         * @param &crc Reference to the CRC-32 of the preceding data, updated on success
+         * @param buffer Char array of 2 * chunk_size bytes, one chunk being filled while the other
+         *               is checksummed
+         * @param chunk_size Maximum amount of data to read per transaction
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t update_region_crc(uint32_t address, int data_length, uint32_t &crc, char *buffer, int chunk_size);
+
+#if DEVICE_I2C_ASYNCH
+        /** Record the outcome of an asynchronous chunk transfer made by update_region_crc
+         * 
+         * @param event I2C event flags describing how the transfer ended
+         */
+        void scan_transfer_done(int event);
+#endif
+
+        /** Program up to one page of data in a single I2C transaction; the address bytes and
+         *  data are clocked out back to back, followed by a stop condition which begins the
+         *  EEPROM's internal write cycle
+         * 
+         * @param address Address pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes, must not cross a page boundary
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t write_page(uint32_t address, const char *data, int data_length);
+
+        /** Read data_length bytes from address into data in the current read mode, splitting the
+         *  read into transactions no longer than the bus hold quantum
+         * 
+         * @param address Address that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_range(uint32_t address, char *data, int data_length);
+
+        /** Read data_length bytes from address into data through the read cache, filling the cache
+         *  with any pages that are not already held
+         * 
+         * @param address Address that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_through_cache(uint32_t address, char *data, int data_length);
+
+        /** Read data_length bytes from address into data through the read-ahead buffer,
+         *  prefetching if the read continues a sequential access pattern
+         * 
+         * @param address Address that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_through_read_ahead(uint32_t address, char *data, int data_length);
+
+        /** Ensure that data_length bytes at address lie within the memory array
+         * 
+         * @param address Address pointing to the start of the data
+         * @param data_length Amount of data in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t check_range_args(uint32_t address, int data_length);
+
+        /** Ensure that a write of data_length bytes to address is within the constraints of
+         *  the EEPROM
+         * 
+         * @param address Address pointing to where the write operation will begin
+         * @param data_length Amount of data to write in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t check_write_args(uint32_t address, int data_length);
+
+        /** Drop any copy of data_length bytes at address held by the read cache or read-ahead
+         *  buffer, after a write to them failed and the EEPROM may hold something other than was
+         *  written
+         * 
+         * @param address Address pointing to the start of the data
+         * @param data_length Amount of data in bytes
+         */
+        void discard_cached(uint32_t address, int data_length);
+
+        /** Read back one page slice of a completed write and compare it with the source data,
+         *  EEPROM_VERIFY_CHUNK_SIZE bytes at a time, stopping at the first mismatch
+         * 
+         * @param slice Page slice of the write operation to verify
+         * @param data Char array storing data that was written
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t verify_slice(const Page_Slice &slice, const char *data);
+
+        /** In EEPROM_WRITE_SKIP_UNCHANGED mode, determine whether a page slice of a write already
+         *  holds the data to be written. Slices that cannot be read are treated as changed
+         * 
+         * @param slice Page slice of the write operation to check
+         * @param data Char array storing data to be written
+         * @return Returns true if programming the slice can be skipped
+         */
+        bool slice_unchanged(const Page_Slice &slice, const char *data);
+
+        /** Perform the next step of an asynchronous write; poll for the end of a write cycle,
+         *  program the next page or verify the next page. Called from the event queue
+         */
+        void write_async_step();
+
+        /** Queue the next step of an asynchronous write. If the event queue has no room for it the
+         *  write can make no further progress, so it is concluded with EEPROM_EVENT_QUEUE_FULL
+         * 
+         * @param delay_ms Delay before the step is performed in milliseconds, or 0 to perform it
+         *                 as soon as possible
+         */
+        void schedule_write_async_step(int delay_ms);
+
+        /** Conclude an asynchronous write and notify the caller of its status
+         * 
+         * @param status Final status of the asynchronous write
+         */
+        void write_async_complete(EEPROM_Status_t status);
+
+        /** Poll the device select code until the EEPROM acknowledges it, indicating that it is not
+         *  busy with an internal write cycle
+         * 
+         * @param timeout_us Maximum amount of time to poll for in microseconds
+         * @param &elapsed_us Reference to an integer object to store the time taken to acknowledge in
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t poll_device_select(int timeout_us, int &elapsed_us);
+
+        /** Wait between two attempts at a read according to the retry policy
+         * 
+         * @param &delay_us Reference to the current backoff delay, updated for the next attempt
+         * @param remaining_us Time left before the retry policy deadline, or -1 if there is none
+         */
+        void retry_backoff(int &delay_us, int remaining_us);
 
         DigitalOut _write_control;
 
         I2C _i2c;
 
+        int _device_select;
+
+        PlatformMutex _mutex;
+
+        int _bus_hold_quantum;
+
+        Timer _bus_hold_timer;
+
+        uint32_t _bus_hold_histogram[EEPROM_BUS_HOLD_BUCKETS];
+
+        int _bus_hold_max_us;
+
         int _i2c_frequency_hz;     
-};
\ No newline at end of file
+
+        EEPROM_Read_Mode_t _read_mode;
+
+        /** Mirror of the EEPROM's internal address counter, -1 when it is not known
+         */
+        int _address_counter;
+
+        EEPROM_Write_Mode_t _write_mode;
+
+        EEPROM_Write_Stats_t _write_stats;
+
+        EEPROM_Verify_Mode_t _verify_mode;
+
+        EEPROM_Retry_Policy_t _retry_policy;
+
+        EEPROM_Retry_Stats_t _retry_stats;
+
+        int _write_cycle_timeout_us;
+
+        /** Set once a page has been programmed, until its write cycle is known to have completed
+         */
+        bool _write_cycle_pending;
+
+        events::EventQueue *_event_queue;
+
+        uint32_t _async_address;
+
+        int _async_length;
+
+        const char *_async_data;
+
+        EEPROM_Callback_t _async_callback;
+
+        Page_Slicer _async_slicer;
+
+        Page_Slicer _async_verify_slicer;
+
+        Page_Slice _async_last_slice;
+
+        uint32_t _async_crc;
+
+        uint32_t _async_crc_expected;
+
+#if DEVICE_I2C_ASYNCH
+        volatile int _scan_event;
+#endif
+
+        bool _async_pending;
+
+        int _async_event;
+
+        bool _async_verify;
+
+        bool _async_write_cycle;
+
+        Timer _async_timer;
+
+        STM24xxx_Read_Cache<STM24xxx> *_read_cache;
+
+        char *_read_ahead_buffer;
+
+        int _read_ahead_size;
+
+        int _read_ahead_address;
+
+        int _read_ahead_length;
+
+        int _read_ahead_window;
+
+        int _read_ahead_next;
+
+        int _last_write_cycle_us;
+};
+
+/** Parts of the M24xxx family supported by the driver
+ */
+typedef STM24xxx<32, 8192, 2> STM24C64;
+typedef STM24xxx<64, 32768, 2> STM24256;
+typedef STM24xxx<128, 65536, 2> STM24512;
+typedef STM24xxx<256, 131072, 2> STM24M01;
+typedef STM24xxx<256, 262144, 2> STM24M02;
@@ -0,0 +1,113 @@
+/**
+  * @file    STM24256_CRC.cpp
+  * @version 1.18.0
+  * @author  Adam Mitchell
+  * @brief   C++ file of the CRC-32 module used by the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_CRC.h"
+
+/** Slicing-by-8 lookup tables. Row 0 is the conventional byte-at-a-time table; row n gives
+ *  the CRC of a byte followed by n zero bytes, which lets 8 bytes be folded in at once
+ */
+struct CRC32_Tables
+{
+    uint32_t row[8][256];
+
+    constexpr CRC32_Tables() : row()
+    {
+        for(int i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for(int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+            }
+
+            row[0][i] = crc;
+        }
+
+        for(int n = 1; n < 8; n++)
+        {
+            for(int i = 0; i < 256; i++)
+            {
+                row[n][i] = (row[n - 1][i] >> 8) ^ row[0][row[n - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+/** Generated at compile time, so the tables are placed in flash rather than RAM
+ */
+static constexpr CRC32_Tables crc32_tables;
+
+static_assert(crc32_tables.row[0][1] == 0x77073096, "CRC-32 table generated incorrectly");
+
+STM24256_CRC::CRC_Hook_t STM24256_CRC::_hardware_hook = NULL;
+
+/** Continue a CRC-32 over further data. Start with a crc of 0; the value returned after
+ *  each call is the finished CRC-32 of all data passed so far
+ * 
+ * @param crc CRC-32 of the preceding data, or 0 to begin a new CRC
+ * @param data Char array storing data to be included in the CRC
+ * @param data_length Amount of data in bytes
+ * @return CRC-32 of the preceding data followed by data
+ */
+uint32_t STM24256_CRC::crc32(uint32_t crc, const char *data, int data_length)
+{
+    if(_hardware_hook != NULL)
+    {
+        return _hardware_hook(crc, data, data_length);
+    }
+
+    return crc32_software(crc, data, data_length);
+}
+
+/** Compute a CRC-32 using the software kernel, regardless of any hardware hook
+ * 
+ * @param crc CRC-32 of the preceding data, or 0 to begin a new CRC
+ * @param data Char array storing data to be included in the CRC
+ * @param data_length Amount of data in bytes
+ * @return CRC-32 of the preceding data followed by data
+ */
+uint32_t STM24256_CRC::crc32_software(uint32_t crc, const char *data, int data_length)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    const uint32_t (*row)[256] = crc32_tables.row;
+
+    crc = ~crc;
+
+    /** Bytes are combined explicitly rather than loaded as words, so that the result does not
+     *  depend on the endianness or alignment requirements of the target
+     */
+    while(data_length >= 8)
+    {
+        uint32_t low = crc ^ (bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+
+        crc = row[7][low & 0xFF] ^ row[6][(low >> 8) & 0xFF] ^
+              row[5][(low >> 16) & 0xFF] ^ row[4][low >> 24] ^
+              row[3][bytes[4]] ^ row[2][bytes[5]] ^
+              row[1][bytes[6]] ^ row[0][bytes[7]];
+
+        bytes += 8;
+        data_length -= 8;
+    }
+
+    while(data_length-- > 0)
+    {
+        crc = (crc >> 8) ^ row[0][(crc ^ *bytes++) & 0xFF];
+    }
+
+    return ~crc;
+}
+
+/** Install a hardware CRC-32 implementation to be used by crc32
+ * 
+ * @param hook Hardware implementation, or NULL to revert to the software kernel
+ */
+void STM24256_CRC::set_hardware_hook(CRC_Hook_t hook)
+{
+    _hardware_hook = hook;
+}
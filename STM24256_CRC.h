@@ -0,0 +1,58 @@
+/**
+  * @file    STM24256_CRC.h
+  * @version 1.18.0
+  * @author  Adam Mitchell
+  * @brief   Header file of the CRC-32 module used by the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+
+/** CRC-32 as used by Ethernet and zlib (reflected polynomial 0xEDB88320). The software kernel
+ *  processes 8 bytes per step using slicing-by-8 lookup tables that are generated at compile
+ *  time. Targets with a CRC peripheral may install a hardware hook which is then used instead
+ */
+class STM24256_CRC
+{
+
+    public:
+
+        /** Signature of a hardware CRC-32 implementation. It must continue the CRC-32 crc over
+         *  data_length bytes of data and return the result, exactly as crc32 does
+         */
+        typedef uint32_t (*CRC_Hook_t)(uint32_t crc, const char *data, int data_length);
+
+        /** Continue a CRC-32 over further data. Start with a crc of 0; the value returned after
+         *  each call is the finished CRC-32 of all data passed so far
+         * 
+         * @param crc CRC-32 of the preceding data, or 0 to begin a new CRC
+         * @param data Char array storing data to be included in the CRC
+         * @param data_length Amount of data in bytes
+         * @return CRC-32 of the preceding data followed by data
+         */
+        static uint32_t crc32(uint32_t crc, const char *data, int data_length);
+
+        /** Compute a CRC-32 using the software kernel, regardless of any hardware hook
+         * 
+         * @param crc CRC-32 of the preceding data, or 0 to begin a new CRC
+         * @param data Char array storing data to be included in the CRC
+         * @param data_length Amount of data in bytes
+         * @return CRC-32 of the preceding data followed by data
+         */
+        static uint32_t crc32_software(uint32_t crc, const char *data, int data_length);
+
+        /** Install a hardware CRC-32 implementation to be used by crc32
+         * 
+         * @param hook Hardware implementation, or NULL to revert to the software kernel
+         */
+        static void set_hardware_hook(CRC_Hook_t hook);
+
+    private:
+
+        static CRC_Hook_t _hardware_hook;
+};
@@ -0,0 +1,703 @@
+/**
+  * @file    STM24256_Mirror.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   C++ file of the mirrored EEPROM pair for the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_Mirror.h"
+
+/** Constructor. Create a mirror of two EEPROMs
+ * 
+ * @param primary EEPROM driver holding the first copy
+ * @param secondary EEPROM driver holding the second copy
+ */
+template<class EEPROM_Type>
+STM24xxx_Mirror<EEPROM_Type>::STM24xxx_Mirror(EEPROM_Type &primary, EEPROM_Type &secondary) :
+                                              _next_read(0)
+{
+    _chips[0] = &primary;
+    _chips[1] = &secondary;
+
+    /** Nothing is known of the copies held before the mirror was created
+     */
+    memset(_consistent, 0, sizeof(_consistent));
+    memset(_sequences, 0xFF, sizeof(_sequences));
+
+    reset_mirror_stats();
+}
+
+/** Determine whether or not both copies of a page are known to hold the same sequence
+ *  number, so that reads need not check the other copy
+ * 
+ * @param page Index of the page within both EEPROMs
+ * @return Returns true if the copies of the page are known to agree
+ */
+template<class EEPROM_Type>
+bool STM24xxx_Mirror<EEPROM_Type>::is_consistent(uint32_t page)
+{
+    return (_consistent[page / 8] & (1 << (page % 8))) != 0;
+}
+
+/** Record whether or not both copies of a page are known to hold the same sequence number,
+ *  and if they are, which
+ * 
+ * @param page Index of the page within both EEPROMs
+ * @param consistent Decide whether the copies of the page are known to agree
+ * @param sequence Sequence number held by both copies, or -1 if they are erased. Ignored
+ *                 unless consistent is true
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::set_consistent(uint32_t page, bool consistent, int32_t sequence)
+{
+    if(consistent)
+    {
+        _consistent[page / 8] |= (uint8_t)(1 << (page % 8));
+
+        /** An erased page is kept as 0xFFFF, which is followed by 0 just as -1 is
+         */
+        _sequences[page] = (uint16_t)sequence;
+    }
+    else
+    {
+        _consistent[page / 8] &= (uint8_t)~(1 << (page % 8));
+    }
+}
+
+/** Determine whether one sequence number is newer than another. Sequence numbers are
+ *  compared modulo 2^16, and an erased page is older than any page that has been written
+ * 
+ * @param sequence Sequence number to test, or -1 for an erased page
+ * @param than Sequence number to compare against, or -1 for an erased page
+ * @return Returns true if sequence is newer than than
+ */
+template<class EEPROM_Type>
+bool STM24xxx_Mirror<EEPROM_Type>::is_newer(int32_t sequence, int32_t than)
+{
+    if(sequence < 0)
+    {
+        return false;
+    }
+
+    if(than < 0)
+    {
+        return true;
+    }
+
+    return (int16_t)(sequence - than) > 0;
+}
+
+/** Read a whole page from one EEPROM and check it against its CRC
+ * 
+ * @param chip Index of the EEPROM to read from
+ * @param page Index of the page within the EEPROM
+ * @param data Char array of EEPROM_PAGE_SIZE bytes in which to store the page
+ * @param &sequence Reference to an int32_t in which to store the sequence number of the
+ *                  page, or -1 if it is erased
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::read_copy(int chip, uint32_t page, char *data, int32_t &sequence)
+{
+    EEPROM_Status_t status = _chips[chip]->read_from_address(page * EEPROM_PAGE_SIZE, data, EEPROM_PAGE_SIZE);
+    if(status != EEPROM_Type::EEPROM_OK)
+    {
+        return status;
+    }
+
+    _mirror_stats.reads[chip]++;
+
+    /** A page never written through the mirror is still erased and has no CRC
+     */
+    bool erased = true;
+    for(int i = 0; i < EEPROM_PAGE_SIZE; i++)
+    {
+        if(data[i] != (char)0xFF)
+        {
+            erased = false;
+            break;
+        }
+    }
+
+    if(erased)
+    {
+        sequence = -1;
+        return EEPROM_Type::EEPROM_OK;
+    }
+
+    const int crc_offset = EEPROM_MIRROR_PAGE_DATA_SIZE + EEPROM_MIRROR_SEQUENCE_SIZE;
+
+    uint32_t crc = STM24256_CRC::crc32(0, data, crc_offset);
+    for(int i = 0; i < EEPROM_MIRROR_CRC_SIZE; i++)
+    {
+        if(data[crc_offset + i] != (char)(crc >> (8 * i)))
+        {
+            return EEPROM_Type::EEPROM_VERIFY_FAIL;
+        }
+    }
+
+    sequence = (uint8_t)data[EEPROM_MIRROR_PAGE_DATA_SIZE] | ((uint8_t)data[EEPROM_MIRROR_PAGE_DATA_SIZE + 1] << 8);
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Read only the sequence number and CRC at the end of a page from one EEPROM
+ * 
+ * @param chip Index of the EEPROM to read from
+ * @param page Index of the page within the EEPROM
+ * @param &sequence Reference to an int32_t in which to store the sequence number of the
+ *                  page, or -1 if it appears erased
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::read_sequence(int chip, uint32_t page, int32_t &sequence)
+{
+    char trailer[EEPROM_MIRROR_SEQUENCE_SIZE + EEPROM_MIRROR_CRC_SIZE];
+
+    EEPROM_Status_t status = _chips[chip]->read_from_address(page * EEPROM_PAGE_SIZE + EEPROM_MIRROR_PAGE_DATA_SIZE, trailer, sizeof(trailer));
+    if(status != EEPROM_Type::EEPROM_OK)
+    {
+        return status;
+    }
+
+    sequence = -1;
+    for(unsigned int i = 0; i < sizeof(trailer); i++)
+    {
+        if(trailer[i] != (char)0xFF)
+        {
+            sequence = (uint8_t)trailer[0] | ((uint8_t)trailer[1] << 8);
+            break;
+        }
+    }
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Overwrite a stale or damaged copy of a page with a valid copy. The copies are only known
+ *  to agree once the repaired copy has been checked on the EEPROM itself
+ * 
+ * @param chip Index of the EEPROM holding the stale or damaged copy
+ * @param page Index of the page within the EEPROM
+ * @param data Char array of EEPROM_PAGE_SIZE bytes holding the valid copy
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::repair_copy(int chip, uint32_t page, const char *data)
+{
+    if(_chips[chip]->program_page(page * EEPROM_PAGE_SIZE, data, EEPROM_PAGE_SIZE) != EEPROM_Type::EEPROM_OK)
+    {
+        return;
+    }
+
+    _mirror_stats.repairs++;
+
+    /** A repair dropped by the EEPROM leaves the page to be checked and repaired again by the
+     *  next read, rather than serving the stale copy from then on
+     */
+    if(_chips[chip]->verify_at_address(page * EEPROM_PAGE_SIZE, data, EEPROM_PAGE_SIZE) == EEPROM_Type::EEPROM_OK)
+    {
+        int32_t sequence = (uint8_t)data[EEPROM_MIRROR_PAGE_DATA_SIZE] | ((uint8_t)data[EEPROM_MIRROR_PAGE_DATA_SIZE + 1] << 8);
+        set_consistent(page, true, sequence);
+    }
+}
+
+/** Read the newest valid copy of a whole page from the preferred EEPROM, or from the
+ *  other one if its copy is newer, cannot be read or does not match its CRC
+ * 
+ * @param page Index of the page within both EEPROMs
+ * @param data Char array of EEPROM_PAGE_SIZE bytes in which to store the page
+ * @param &sequence Reference to an int32_t in which to store the sequence number of the
+ *                  page, or -1 if it is erased
+ * @param for_write Decide whether the page is read to merge a partial write into it. Such a
+ *                  read always compares the sequence numbers of both copies, waiting for an
+ *                  EEPROM busy with a write cycle, and leaves a stale or damaged copy to be
+ *                  replaced by the write rather than repairing it
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::read_page(uint32_t page, char *data, int32_t &sequence, bool for_write)
+{
+    /** Alternate between the EEPROMs, unless only the other one is free of a write cycle
+     */
+    int chip = _next_read;
+    if(!_chips[chip]->is_write_cycle_complete() && _chips[chip ^ 1]->is_write_cycle_complete())
+    {
+        chip ^= 1;
+    }
+    _next_read = chip ^ 1;
+
+    EEPROM_Status_t status = read_copy(chip, page, data, sequence);
+    if(status == EEPROM_Type::EEPROM_OK)
+    {
+        /** Both copies pass their CRC after a write that reached only one of them, so the
+         *  sequence number of the other copy decides which is current. A read only checks it
+         *  until the copies are known to agree, and never while the other EEPROM is busy, so
+         *  that it is not held up by the write cycle it was steered away from. A partial write
+         *  always checks it, as merging into a stale copy would destroy the newer one
+         */
+        if(!for_write && (is_consistent(page) || !_chips[chip ^ 1]->is_write_cycle_complete()))
+        {
+            return EEPROM_Type::EEPROM_OK;
+        }
+
+        int32_t other_sequence;
+        if(read_sequence(chip ^ 1, page, other_sequence) != EEPROM_Type::EEPROM_OK)
+        {
+            return EEPROM_Type::EEPROM_OK;
+        }
+
+        if(other_sequence == sequence)
+        {
+            set_consistent(page, true, sequence);
+            return EEPROM_Type::EEPROM_OK;
+        }
+
+        if(is_newer(other_sequence, sequence))
+        {
+            char other_data[EEPROM_PAGE_SIZE];
+            int32_t checked_sequence;
+
+            if(read_copy(chip ^ 1, page, other_data, checked_sequence) == EEPROM_Type::EEPROM_OK && is_newer(checked_sequence, sequence))
+            {
+                memcpy(data, other_data, EEPROM_PAGE_SIZE);
+                sequence = checked_sequence;
+
+                if(!for_write)
+                {
+                    repair_copy(chip, page, data);
+                }
+
+                return EEPROM_Type::EEPROM_OK;
+            }
+        }
+
+        /** The other copy is either stale or damaged
+         */
+        if(!for_write)
+        {
+            repair_copy(chip ^ 1, page, data);
+        }
+
+        return EEPROM_Type::EEPROM_OK;
+    }
+
+    _mirror_stats.fallbacks++;
+
+    EEPROM_Status_t other_status = read_copy(chip ^ 1, page, data, sequence);
+    if(other_status == EEPROM_Type::EEPROM_OK)
+    {
+        if(!for_write && status == EEPROM_Type::EEPROM_VERIFY_FAIL)
+        {
+            repair_copy(chip, page, data);
+        }
+
+        return EEPROM_Type::EEPROM_OK;
+    }
+
+    /** Only report both copies as damaged if neither failure was a failure to read
+     */
+    if(status != EEPROM_Type::EEPROM_VERIFY_FAIL)
+    {
+        return status;
+    }
+
+    return other_status;
+}
+
+/** Read data_length bytes from address into data
+ * 
+ * @param address Address within the mirror that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::read_from_address(uint32_t address, char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= get_size() || (uint32_t)data_length > get_size() - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    char page_data[EEPROM_PAGE_SIZE];
+    int offset = 0;
+
+    while(offset < data_length)
+    {
+        uint32_t page = (address + offset) / EEPROM_MIRROR_PAGE_DATA_SIZE;
+        int page_offset = (address + offset) % EEPROM_MIRROR_PAGE_DATA_SIZE;
+
+        int length = EEPROM_MIRROR_PAGE_DATA_SIZE - page_offset;
+        if(length > data_length - offset)
+        {
+            length = data_length - offset;
+        }
+
+        int32_t sequence;
+        EEPROM_Status_t status = read_page(page, page_data, sequence, false);
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            _mutex.unlock();
+            return status;
+        }
+
+        memcpy(&data[offset], &page_data[page_offset], length);
+        offset += length;
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Write data_length bytes from data to address in both EEPROMs and check both copies.
+ *  Pages only partially covered by the write are read first, from the newer of their two
+ *  copies, so that their CRC can be recomputed; if both copies of such a page are damaged
+ *  the write stops with EEPROM_VERIFY_FAIL rather than overwrite data it does not have,
+ *  see erase_page
+ * 
+ * @param address Address within the mirror pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @return Indicates success or failure reason. If one copy fails to be programmed or
+ *         verified, the other is still written and the failure is returned
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::write_to_address(uint32_t address, const char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= get_size() || (uint32_t)data_length > get_size() - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    /** The page being programmed and the previous one, whose copies are checked meanwhile
+     */
+    Mirror_Commit_t commits[2];
+    Mirror_Commit_t *previous = NULL;
+    int current = 0;
+    int offset = 0;
+    bool prefetched = false;
+    int32_t prefetched_sequence = -1;
+    EEPROM_Status_t result = EEPROM_Type::EEPROM_OK;
+
+    while(offset < data_length)
+    {
+        uint32_t page = (address + offset) / EEPROM_MIRROR_PAGE_DATA_SIZE;
+        int page_offset = (address + offset) % EEPROM_MIRROR_PAGE_DATA_SIZE;
+
+        int length = EEPROM_MIRROR_PAGE_DATA_SIZE - page_offset;
+        if(length > data_length - offset)
+        {
+            length = data_length - offset;
+        }
+
+        Mirror_Commit_t &commit = commits[current];
+        int32_t sequence = -1;
+
+        if(length < EEPROM_MIRROR_PAGE_DATA_SIZE)
+        {
+            /** The rest of a page whose copies are both damaged is lost, and must not be
+             *  replaced without the caller asking for it
+             */
+            EEPROM_Status_t status = read_page(page, commit.data, sequence, true);
+            if(status != EEPROM_Type::EEPROM_OK)
+            {
+                if(previous != NULL)
+                {
+                    verify_copy(0, *previous);
+                    verify_copy(1, *previous);
+                    finish_commit(*previous);
+                }
+
+                _mutex.unlock();
+                return status;
+            }
+        }
+        else if(prefetched)
+        {
+            sequence = prefetched_sequence;
+        }
+        else
+        {
+            sequence = known_sequence(page);
+        }
+
+        memcpy(&commit.data[page_offset], &data[offset], length);
+        stamp_page(commit, page, sequence);
+
+        /** The sequence number of the next page, if it is written in full and not known, is
+         *  read from each EEPROM while it is idle rather than once it is busy again
+         */
+        prefetched = data_length - offset - length >= EEPROM_MIRROR_PAGE_DATA_SIZE && !is_consistent(page + 1);
+        prefetched_sequence = -1;
+
+        /** Each EEPROM checks its copy of the previous page once that write cycle is over and
+         *  is then given the next page, so that one EEPROM is read and programmed during the
+         *  write cycle of the other and the pair takes little longer than a single EEPROM
+         */
+        for(int chip = 0; chip < 2; chip++)
+        {
+            if(previous != NULL)
+            {
+                verify_copy(chip, *previous);
+            }
+
+            int32_t chip_sequence;
+            if(prefetched && read_sequence(chip, page + 1, chip_sequence) == EEPROM_Type::EEPROM_OK && 
+               is_newer(chip_sequence, prefetched_sequence))
+            {
+                prefetched_sequence = chip_sequence;
+            }
+
+            program_copy(chip, commit);
+        }
+
+        if(previous != NULL)
+        {
+            EEPROM_Status_t status = finish_commit(*previous);
+            if(status != EEPROM_Type::EEPROM_OK && result == EEPROM_Type::EEPROM_OK)
+            {
+                result = status;
+            }
+        }
+
+        previous = &commit;
+        current ^= 1;
+        offset += length;
+    }
+
+    verify_copy(0, *previous);
+    verify_copy(1, *previous);
+
+    EEPROM_Status_t status = finish_commit(*previous);
+    if(status != EEPROM_Type::EEPROM_OK && result == EEPROM_Type::EEPROM_OK)
+    {
+        result = status;
+    }
+
+    _mutex.unlock();
+
+    return result;
+}
+
+/** Reinitialise the page of the mirror holding address, whatever its copies hold, so that its
+ *  data reads as erased. This recovers a page whose copies are both damaged, to which partial
+ *  writes are refused, at the cost of the rest of the data in that page
+ * 
+ * @param address Any address within the page of the mirror to reinitialise
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::erase_page(uint32_t address)
+{
+    if(address >= get_size())
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    uint32_t page = address / EEPROM_MIRROR_PAGE_DATA_SIZE;
+
+    Mirror_Commit_t commit;
+    memset(commit.data, 0xFF, EEPROM_MIRROR_PAGE_DATA_SIZE);
+    stamp_page(commit, page, known_sequence(page));
+
+    for(int chip = 0; chip < 2; chip++)
+    {
+        program_copy(chip, commit);
+    }
+
+    for(int chip = 0; chip < 2; chip++)
+    {
+        verify_copy(chip, commit);
+    }
+
+    EEPROM_Status_t status = finish_commit(commit);
+
+    _mutex.unlock();
+
+    return status;
+}
+
+/** Find the newest sequence number recorded in either copy of a page, so that a page about
+ *  to be written in full is given a newer one
+ * 
+ * @param page Index of the page within both EEPROMs
+ * @return Newest sequence number of the page, or -1 if neither copy has one
+ */
+template<class EEPROM_Type>
+int32_t STM24xxx_Mirror<EEPROM_Type>::newest_sequence(uint32_t page)
+{
+    int32_t sequence = -1;
+
+    for(int chip = 0; chip < 2; chip++)
+    {
+        int32_t chip_sequence;
+        if(read_sequence(chip, page, chip_sequence) == EEPROM_Type::EEPROM_OK && is_newer(chip_sequence, sequence))
+        {
+            sequence = chip_sequence;
+        }
+    }
+
+    return sequence;
+}
+
+/** Find the sequence number of a page about to be written in full, from memory if both
+ *  copies are known to agree, otherwise from the EEPROMs
+ * 
+ * @param page Index of the page within both EEPROMs
+ * @return Newest sequence number of the page, or -1 if neither copy has one
+ */
+template<class EEPROM_Type>
+int32_t STM24xxx_Mirror<EEPROM_Type>::known_sequence(uint32_t page)
+{
+    if(is_consistent(page))
+    {
+        return _sequences[page];
+    }
+
+    return newest_sequence(page);
+}
+
+/** Prepare a page to be committed to both EEPROMs, stamping it with the sequence number
+ *  following sequence and its CRC
+ * 
+ * @param &commit Reference to the commit to prepare, whose first EEPROM_MIRROR_PAGE_DATA_SIZE
+ *                bytes of data hold the data of the page. The trailer is filled in
+ * @param page Index of the page within both EEPROMs
+ * @param sequence Sequence number of the page being replaced, or -1 if it is erased
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::stamp_page(Mirror_Commit_t &commit, uint32_t page, int32_t sequence)
+{
+    uint16_t next_sequence = (uint16_t)(sequence + 1);
+    commit.data[EEPROM_MIRROR_PAGE_DATA_SIZE] = (char)next_sequence;
+    commit.data[EEPROM_MIRROR_PAGE_DATA_SIZE + 1] = (char)(next_sequence >> 8);
+
+    const int crc_offset = EEPROM_MIRROR_PAGE_DATA_SIZE + EEPROM_MIRROR_SEQUENCE_SIZE;
+
+    uint32_t crc = STM24256_CRC::crc32(0, commit.data, crc_offset);
+    for(int i = 0; i < EEPROM_MIRROR_CRC_SIZE; i++)
+    {
+        commit.data[crc_offset + i] = (char)(crc >> (8 * i));
+    }
+
+    commit.page = page;
+    commit.sequence = next_sequence;
+    commit.programmed[0] = false;
+    commit.programmed[1] = false;
+    commit.status = EEPROM_Type::EEPROM_OK;
+
+    /** Until both copies have been checked they may not agree
+     */
+    set_consistent(page, false, -1);
+}
+
+/** Program one copy of a page. program_page only waits for the write cycle of the page
+ *  previously written to that EEPROM, not for its own
+ * 
+ * @param chip Index of the EEPROM to program
+ * @param &commit Reference to the commit holding the page
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::program_copy(int chip, Mirror_Commit_t &commit)
+{
+    EEPROM_Status_t status = _chips[chip]->program_page(commit.page * EEPROM_PAGE_SIZE, commit.data, EEPROM_PAGE_SIZE);
+
+    commit.programmed[chip] = status == EEPROM_Type::EEPROM_OK;
+    if(status != EEPROM_Type::EEPROM_OK && commit.status == EEPROM_Type::EEPROM_OK)
+    {
+        commit.status = status;
+    }
+}
+
+/** Check one copy of a page on the EEPROM itself once its write cycle has completed, a write
+ *  silently dropped by one EEPROM would otherwise go unnoticed until it is read
+ * 
+ * @param chip Index of the EEPROM to check
+ * @param &commit Reference to the commit holding the page
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::verify_copy(int chip, Mirror_Commit_t &commit)
+{
+    if(!commit.programmed[chip])
+    {
+        return;
+    }
+
+    EEPROM_Status_t status = _chips[chip]->verify_at_address(commit.page * EEPROM_PAGE_SIZE, commit.data, EEPROM_PAGE_SIZE);
+    if(status != EEPROM_Type::EEPROM_OK && commit.status == EEPROM_Type::EEPROM_OK)
+    {
+        commit.status = status;
+    }
+}
+
+/** Conclude the commit of a page once both copies have been checked, recording whether they
+ *  are known to agree
+ * 
+ * @param &commit Reference to the commit holding the page
+ * @return Indicates success or failure reason. If one copy failed to be programmed or
+ *         verified, the other was still written and the failure is returned
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Mirror<EEPROM_Type>::EEPROM_Status_t STM24xxx_Mirror<EEPROM_Type>::finish_commit(Mirror_Commit_t &commit)
+{
+    set_consistent(commit.page, commit.status == EEPROM_Type::EEPROM_OK, commit.sequence);
+
+    return commit.status;
+}
+
+/** Get the size of the mirror
+ * 
+ * @return Amount of data the mirror can hold in bytes
+ */
+template<class EEPROM_Type>
+uint32_t STM24xxx_Mirror<EEPROM_Type>::get_size()
+{
+    return (uint32_t)(EEPROM_MEM_ARRAY_SIZE / EEPROM_PAGE_SIZE) * EEPROM_MIRROR_PAGE_DATA_SIZE;
+}
+
+/** Get the running totals of reads served by each EEPROM, of fallbacks and of repairs
+ * 
+ * @param &stats Reference to an EEPROM_Mirror_Stats_t object to copy the totals into
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::get_mirror_stats(EEPROM_Mirror_Stats_t &stats)
+{
+    stats = _mirror_stats;
+}
+
+/** Reset the mirror totals to zero
+ */
+template<class EEPROM_Type>
+void STM24xxx_Mirror<EEPROM_Type>::reset_mirror_stats()
+{
+    _mirror_stats.reads[0] = 0;
+    _mirror_stats.reads[1] = 0;
+    _mirror_stats.fallbacks = 0;
+    _mirror_stats.repairs = 0;
+}
+
+/** Parts of the M24xxx family for which the mirror is compiled
+ */
+template class STM24xxx_Mirror<STM24C64>;
+template class STM24xxx_Mirror<STM24256>;
+template class STM24xxx_Mirror<STM24512>;
+template class STM24xxx_Mirror<STM24M01>;
+template class STM24xxx_Mirror<STM24M02>;
@@ -0,0 +1,288 @@
+/**
+  * @file    STM24256_Mirror.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Header file of the mirrored EEPROM pair for the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+#include "STM24256.h"
+#include "STM24256_CRC.h"
+
+/** Size in bytes of the sequence number stored near the end of each page of a mirror
+ */
+#define EEPROM_MIRROR_SEQUENCE_SIZE 2
+
+/** Size in bytes of the CRC-32 stored at the end of each page of a mirror
+ */
+#define EEPROM_MIRROR_CRC_SIZE 4
+
+/** Two identical EEPROMs, on the same bus or on different buses, holding the same data. Each
+ *  page is programmed into both EEPROMs, the second being written while the first performs its
+ *  internal write cycle, then both copies are read back from the EEPROMs and checked. Each
+ *  EEPROM checks a page while the other is in its write cycle and is then given the next, so
+ *  a write takes little longer than on a single EEPROM
+ * 
+ *  Every page ends with a sequence number, incremented each time the page is written, followed
+ *  by a CRC-32 of the rest of the page. Reads are served from whichever EEPROM is not busy with
+ *  a write cycle, alternating between the two when both are idle. The first time a page is
+ *  read, the sequence number of the other copy is also checked if that EEPROM is idle, so that
+ *  the newest valid copy is returned and a stale copy, left by a write that reached only one
+ *  EEPROM, is repaired from it. Pages whose copies are known to agree, having been written,
+ *  checked or repaired since the mirror was created, are read from one EEPROM only, and their
+ *  sequence numbers are kept in memory, 2 bytes per page, so that a page written in full need
+ *  not be read first. If a read fails or a page does not match its CRC, the other copy is used
+ *  and the damaged one repaired. A page that has never been written through the mirror reads as erased, and a
+ *  page whose copies are both damaged reads as EEPROM_VERIFY_FAIL until it is rewritten in
+ *  full or reinitialised with erase_page
+ */
+template<class EEPROM_Type>
+class STM24xxx_Mirror
+{
+
+    public:
+
+        /** Geometry and types of the EEPROM driver the mirror is built upon
+         */
+        static constexpr int EEPROM_PAGE_SIZE = EEPROM_Type::EEPROM_PAGE_SIZE;
+        static constexpr int EEPROM_MEM_ARRAY_SIZE = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+        typedef typename EEPROM_Type::EEPROM_Status_t EEPROM_Status_t;
+
+        /** Amount of data held in each page of the mirror once its sequence number and CRC have
+         *  been accounted for
+         */
+        static constexpr int EEPROM_MIRROR_PAGE_DATA_SIZE = EEPROM_PAGE_SIZE - EEPROM_MIRROR_SEQUENCE_SIZE - EEPROM_MIRROR_CRC_SIZE;
+
+        /** Amount of pages in each EEPROM, and so in the mirror
+         */
+        static constexpr int EEPROM_MIRROR_PAGE_COUNT = EEPROM_MEM_ARRAY_SIZE / EEPROM_PAGE_SIZE;
+
+        /** Running totals of reads served by each EEPROM, of reads that had to fall back to the
+         *  other copy and of copies repaired
+         */
+        typedef struct
+        {
+            uint32_t reads[2];
+            uint32_t fallbacks;
+            uint32_t repairs;
+        } EEPROM_Mirror_Stats_t;
+
+        /** Constructor. Create a mirror of two EEPROMs
+         * 
+         * @param primary EEPROM driver holding the first copy
+         * @param secondary EEPROM driver holding the second copy
+         */
+        STM24xxx_Mirror(EEPROM_Type &primary, EEPROM_Type &secondary);
+
+        /** Read data_length bytes from address into data
+         * 
+         * @param address Address within the mirror that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_from_address(uint32_t address, char *data, int data_length);
+
+        /** Write data_length bytes from data to address in both EEPROMs and check both copies.
+         *  Pages only partially covered by the write are read first, from the newer of their two
+         *  copies, so that their CRC can be recomputed; if both copies of such a page are damaged
+         *  the write stops with EEPROM_VERIFY_FAIL rather than overwrite data it does not have,
+         *  see erase_page
+         * 
+         * @param address Address within the mirror pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes
+         * @return Indicates success or failure reason. If one copy fails to be programmed or
+         *         verified, the other is still written and the failure is returned
+         */
+        EEPROM_Status_t write_to_address(uint32_t address, const char *data, int data_length);
+
+        /** Reinitialise the page of the mirror holding address, whatever its copies hold, so that its
+         *  data reads as erased. This recovers a page whose copies are both damaged, to which partial
+         *  writes are refused, at the cost of the rest of the data in that page
+         * 
+         * @param address Any address within the page of the mirror to reinitialise
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t erase_page(uint32_t address);
+
+        /** Get the size of the mirror
+         * 
+         * @return Amount of data the mirror can hold in bytes
+         */
+        uint32_t get_size();
+
+        /** Get the running totals of reads served by each EEPROM, of fallbacks and of repairs
+         * 
+         * @param &stats Reference to an EEPROM_Mirror_Stats_t object to copy the totals into
+         */
+        void get_mirror_stats(EEPROM_Mirror_Stats_t &stats);
+
+        /** Reset the mirror totals to zero
+         */
+        void reset_mirror_stats();
+
+    private:
+
+        /** A page on its way to both EEPROMs, stamped with its sequence number and CRC
+         */
+        typedef struct
+        {
+            uint32_t page;
+            int32_t sequence;
+            char data[EEPROM_PAGE_SIZE];
+            bool programmed[2];
+            EEPROM_Status_t status;
+        } Mirror_Commit_t;
+
+        /** Read the newest valid copy of a whole page from the preferred EEPROM, or from the
+         *  other one if its copy is newer, cannot be read or does not match its CRC
+         * 
+         * @param page Index of the page within both EEPROMs
+         * @param data Char array of EEPROM_PAGE_SIZE bytes in which to store the page
+         * @param &sequence Reference to an int32_t in which to store the sequence number of the
+         *                  page, or -1 if it is erased
+         * @param for_write Decide whether the page is read to merge a partial write into it. Such a
+         *                  read always compares the sequence numbers of both copies, waiting for an
+         *                  EEPROM busy with a write cycle, and leaves a stale or damaged copy to be
+         *                  replaced by the write rather than repairing it
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_page(uint32_t page, char *data, int32_t &sequence, bool for_write);
+
+        /** Read a whole page from one EEPROM and check it against its CRC
+         * 
+         * @param chip Index of the EEPROM to read from
+         * @param page Index of the page within the EEPROM
+         * @param data Char array of EEPROM_PAGE_SIZE bytes in which to store the page
+         * @param &sequence Reference to an int32_t in which to store the sequence number of the
+         *                  page, or -1 if it is erased
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_copy(int chip, uint32_t page, char *data, int32_t &sequence);
+
+        /** Read only the sequence number and CRC at the end of a page from one EEPROM
+         * 
+         * @param chip Index of the EEPROM to read from
+         * @param page Index of the page within the EEPROM
+         * @param &sequence Reference to an int32_t in which to store the sequence number of the
+         *                  page, or -1 if it appears erased
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_sequence(int chip, uint32_t page, int32_t &sequence);
+
+        /** Overwrite a stale or damaged copy of a page with a valid copy. The copies are only known
+         *  to agree once the repaired copy has been checked on the EEPROM itself
+         * 
+         * @param chip Index of the EEPROM holding the stale or damaged copy
+         * @param page Index of the page within the EEPROM
+         * @param data Char array of EEPROM_PAGE_SIZE bytes holding the valid copy
+         */
+        void repair_copy(int chip, uint32_t page, const char *data);
+
+        /** Find the newest sequence number recorded in either copy of a page, so that a page about
+         *  to be written in full is given a newer one
+         * 
+         * @param page Index of the page within both EEPROMs
+         * @return Newest sequence number of the page, or -1 if neither copy has one
+         */
+        int32_t newest_sequence(uint32_t page);
+
+        /** Find the sequence number of a page about to be written in full, from memory if both
+         *  copies are known to agree, otherwise from the EEPROMs
+         * 
+         * @param page Index of the page within both EEPROMs
+         * @return Newest sequence number of the page, or -1 if neither copy has one
+         */
+        int32_t known_sequence(uint32_t page);
+
+        /** Prepare a page to be committed to both EEPROMs, stamping it with the sequence number
+         *  following sequence and its CRC
+         * 
+         * @param &commit Reference to the commit to prepare, whose first EEPROM_MIRROR_PAGE_DATA_SIZE
+         *                bytes of data hold the data of the page. The trailer is filled in
+         * @param page Index of the page within both EEPROMs
+         * @param sequence Sequence number of the page being replaced, or -1 if it is erased
+         */
+        void stamp_page(Mirror_Commit_t &commit, uint32_t page, int32_t sequence);
+
+        /** Program one copy of a page. program_page only waits for the write cycle of the page
+         *  previously written to that EEPROM, not for its own
+         * 
+         * @param chip Index of the EEPROM to program
+         * @param &commit Reference to the commit holding the page
+         */
+        void program_copy(int chip, Mirror_Commit_t &commit);
+
+        /** Check one copy of a page on the EEPROM itself once its write cycle has completed, a write
+         *  silently dropped by one EEPROM would otherwise go unnoticed until it is read
+         * 
+         * @param chip Index of the EEPROM to check
+         * @param &commit Reference to the commit holding the page
+         */
+        void verify_copy(int chip, Mirror_Commit_t &commit);
+
+        /** Conclude the commit of a page once both copies have been checked, recording whether they
+         *  are known to agree
+         * 
+         * @param &commit Reference to the commit holding the page
+         * @return Indicates success or failure reason. If one copy failed to be programmed or
+         *         verified, the other was still written and the failure is returned
+         */
+        EEPROM_Status_t finish_commit(Mirror_Commit_t &commit);
+
+        /** Determine whether or not both copies of a page are known to hold the same sequence
+         *  number, so that reads need not check the other copy
+         * 
+         * @param page Index of the page within both EEPROMs
+         * @return Returns true if the copies of the page are known to agree
+         */
+        bool is_consistent(uint32_t page);
+
+        /** Record whether or not both copies of a page are known to hold the same sequence number,
+         *  and if they are, which
+         * 
+         * @param page Index of the page within both EEPROMs
+         * @param consistent Decide whether the copies of the page are known to agree
+         * @param sequence Sequence number held by both copies, or -1 if they are erased. Ignored
+         *                 unless consistent is true
+         */
+        void set_consistent(uint32_t page, bool consistent, int32_t sequence);
+
+        /** Determine whether one sequence number is newer than another. Sequence numbers are
+         *  compared modulo 2^16, and an erased page is older than any page that has been written
+         * 
+         * @param sequence Sequence number to test, or -1 for an erased page
+         * @param than Sequence number to compare against, or -1 for an erased page
+         * @return Returns true if sequence is newer than than
+         */
+        static bool is_newer(int32_t sequence, int32_t than);
+
+        EEPROM_Type *_chips[2];
+
+        int _next_read;
+
+        EEPROM_Mirror_Stats_t _mirror_stats;
+
+        uint8_t _consistent[(EEPROM_MIRROR_PAGE_COUNT + 7) / 8];
+
+        /** Sequence number of each page whose copies are known to agree
+         */
+        uint16_t _sequences[EEPROM_MIRROR_PAGE_COUNT];
+
+        PlatformMutex _mutex;
+};
+
+/** The mirror for each part of the M24xxx family supported by the driver
+ */
+typedef STM24xxx_Mirror<STM24C64> STM24C64_Mirror;
+typedef STM24xxx_Mirror<STM24256> STM24256_Mirror;
+typedef STM24xxx_Mirror<STM24512> STM24512_Mirror;
+typedef STM24xxx_Mirror<STM24M01> STM24M01_Mirror;
+typedef STM24xxx_Mirror<STM24M02> STM24M02_Mirror;
@@ -0,0 +1,205 @@
+/**
+  * @file    STM24256_Read_Cache.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   C++ file of the LRU read cache for the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_Read_Cache.h"
+
+/** Constructor. Create an empty read cache
+ * 
+ * @param pages Array of page_count pages to use as the cache
+ * @param page_count Amount of pages in the cache. A cache of no pages holds nothing
+ */
+template<class EEPROM_Type>
+STM24xxx_Read_Cache<EEPROM_Type>::STM24xxx_Read_Cache(Cache_Page_t *pages, int page_count) :
+                                         _pages(pages),
+                                         _page_count(page_count),
+                                         _use_counter(0)
+{
+    if(_pages == NULL || _page_count < 0)
+    {
+        _page_count = 0;
+    }
+
+    invalidate_all();
+    reset_stats();
+}
+
+/** Find the cached copy of a page without affecting statistics or recency
+ * 
+ * @param page_address Address of the first byte of the page
+ * @return Pointer to the cached page, or NULL if it is not cached
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Read_Cache<EEPROM_Type>::Cache_Page_t *STM24xxx_Read_Cache<EEPROM_Type>::lookup(uint32_t page_address)
+{
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(_pages[i].valid && _pages[i].address == page_address)
+        {
+            return &_pages[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** Find the cached copy of a page, counting a hit or a miss
+ * 
+ * @param page_address Address of the first byte of the page
+ * @return Pointer to the cached page data, or NULL if it is not cached
+ */
+template<class EEPROM_Type>
+char *STM24xxx_Read_Cache<EEPROM_Type>::find(uint32_t page_address)
+{
+    Cache_Page_t *page = lookup(page_address);
+    if(page == NULL)
+    {
+        _stats.misses++;
+        return NULL;
+    }
+
+    _stats.hits++;
+    page->last_used = ++_use_counter;
+
+    return page->data;
+}
+
+/** Make room for a page in the cache, evicting the least recently used page if required.
+ *  The caller is responsible for filling the page data, or invalidating it if that fails
+ * 
+ * @param page_address Address of the first byte of the page
+ * @return Pointer to the page data, or NULL if the cache has no pages
+ */
+template<class EEPROM_Type>
+char *STM24xxx_Read_Cache<EEPROM_Type>::allocate(uint32_t page_address)
+{
+    if(_page_count == 0)
+    {
+        return NULL;
+    }
+
+    Cache_Page_t *victim = &_pages[0];
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(!_pages[i].valid)
+        {
+            victim = &_pages[i];
+            break;
+        }
+
+        if(_pages[i].last_used < victim->last_used)
+        {
+            victim = &_pages[i];
+        }
+    }
+
+    if(victim->valid)
+    {
+        _stats.evictions++;
+    }
+
+    victim->address = page_address;
+    victim->valid = true;
+    victim->last_used = ++_use_counter;
+
+    return victim->data;
+}
+
+/** Apply data written to the EEPROM to any cached pages it falls within
+ * 
+ * @param address Address pointing to where the write operation began
+ * @param data Char array storing data that was written
+ * @param data_length Amount of data written in bytes
+ */
+template<class EEPROM_Type>
+void STM24xxx_Read_Cache<EEPROM_Type>::update(uint32_t address, const char *data, int data_length)
+{
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        Cache_Page_t *page = lookup(slice.address - (slice.address % EEPROM_PAGE_SIZE));
+        if(page != NULL)
+        {
+            memcpy(&page->data[slice.address % EEPROM_PAGE_SIZE], &data[slice.offset], slice.length);
+        }
+    }
+}
+
+/** Discard any cached pages overlapping a region of the EEPROM
+ * 
+ * @param address Address pointing to the start of the region
+ * @param data_length Length of the region in bytes
+ */
+template<class EEPROM_Type>
+void STM24xxx_Read_Cache<EEPROM_Type>::invalidate(uint32_t address, int data_length)
+{
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        Cache_Page_t *page = lookup(slice.address - (slice.address % EEPROM_PAGE_SIZE));
+        if(page != NULL)
+        {
+            page->valid = false;
+        }
+    }
+}
+
+/** Discard every cached page
+ */
+template<class EEPROM_Type>
+void STM24xxx_Read_Cache<EEPROM_Type>::invalidate_all()
+{
+    for(int i = 0; i < _page_count; i++)
+    {
+        _pages[i].valid = false;
+        _pages[i].last_used = 0;
+    }
+}
+
+/** Get the amount of pages the cache can hold
+ * 
+ * @return Amount of pages in the cache
+ */
+template<class EEPROM_Type>
+int STM24xxx_Read_Cache<EEPROM_Type>::get_page_count()
+{
+    return _page_count;
+}
+
+/** Get the running totals of hits, misses and evictions
+ * 
+ * @param &stats Reference to a Cache_Stats_t object to copy the totals into
+ */
+template<class EEPROM_Type>
+void STM24xxx_Read_Cache<EEPROM_Type>::get_stats(Cache_Stats_t &stats)
+{
+    stats = _stats;
+}
+
+/** Reset the hit, miss and eviction totals to zero
+ */
+template<class EEPROM_Type>
+void STM24xxx_Read_Cache<EEPROM_Type>::reset_stats()
+{
+    _stats.hits = 0;
+    _stats.misses = 0;
+    _stats.evictions = 0;
+}
+
+/** Parts of the M24xxx family for which the cache is compiled
+ */
+template class STM24xxx_Read_Cache<STM24C64>;
+template class STM24xxx_Read_Cache<STM24256>;
+template class STM24xxx_Read_Cache<STM24512>;
+template class STM24xxx_Read_Cache<STM24M01>;
+template class STM24xxx_Read_Cache<STM24M02>;
@@ -0,0 +1,177 @@
+/**
+  * @file    STM24256_Read_Cache.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Header file of the LRU read cache for the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+#include "STM24256.h"
+
+/** Fixed-size least recently used cache of EEPROM pages. Once attached to an STM24256 with
+ *  attach_read_cache, reads of cached pages are served without touching the bus, and
+ *  writes made through the same driver are applied to cached pages so that the cache
+ *  remains coherent with the EEPROM. The pages are either provided by the application or,
+ *  with STM24xxx_Fixed_Read_Cache, held within the cache itself
+ */
+template<class EEPROM_Type>
+class STM24xxx_Read_Cache
+{
+
+    public:
+
+        /** Geometry and types of the EEPROM driver the cache is built upon
+         */
+        static constexpr int EEPROM_PAGE_SIZE = EEPROM_Type::EEPROM_PAGE_SIZE;
+        typedef typename EEPROM_Type::Page_Slicer Page_Slicer;
+        typedef typename EEPROM_Type::Page_Slice Page_Slice;
+
+        /** A single cached page. Storage for these is provided by the application, or by
+         *  STM24xxx_Fixed_Read_Cache whose page count is a template parameter
+         */
+        typedef struct
+        {
+            uint32_t address;
+            bool valid;
+            uint32_t last_used;
+            char data[EEPROM_PAGE_SIZE];
+        } Cache_Page_t;
+
+        /** Running totals of page lookups and evictions
+         */
+        typedef struct
+        {
+            uint32_t hits;
+            uint32_t misses;
+            uint32_t evictions;
+        } Cache_Stats_t;
+
+        /** Constructor. Create an empty read cache
+         * 
+         * @param pages Array of page_count pages to use as the cache
+         * @param page_count Amount of pages in the cache. A cache of no pages holds nothing
+         */
+        STM24xxx_Read_Cache(Cache_Page_t *pages, int page_count);
+
+        /** Find the cached copy of a page, counting a hit or a miss
+         * 
+         * @param page_address Address of the first byte of the page
+         * @return Pointer to the cached page data, or NULL if it is not cached
+         */
+        char *find(uint32_t page_address);
+
+        /** Make room for a page in the cache, evicting the least recently used page if required.
+         *  The caller is responsible for filling the page data, or invalidating it if that fails
+         * 
+         * @param page_address Address of the first byte of the page
+         * @return Pointer to the page data, or NULL if the cache has no pages
+         */
+        char *allocate(uint32_t page_address);
+
+        /** Apply data written to the EEPROM to any cached pages it falls within
+         * 
+         * @param address Address pointing to where the write operation began
+         * @param data Char array storing data that was written
+         * @param data_length Amount of data written in bytes
+         */
+        void update(uint32_t address, const char *data, int data_length);
+
+        /** Discard any cached pages overlapping a region of the EEPROM
+         * 
+         * @param address Address pointing to the start of the region
+         * @param data_length Length of the region in bytes
+         */
+        void invalidate(uint32_t address, int data_length);
+
+        /** Discard every cached page
+         */
+        void invalidate_all();
+
+        /** Get the amount of pages the cache can hold
+         * 
+         * @return Amount of pages in the cache
+         */
+        int get_page_count();
+
+        /** Get the running totals of hits, misses and evictions
+         * 
+         * @param &stats Reference to a Cache_Stats_t object to copy the totals into
+         */
+        void get_stats(Cache_Stats_t &stats);
+
+        /** Reset the hit, miss and eviction totals to zero
+         */
+        void reset_stats();
+
+    private:
+
+        /** Find the cached copy of a page without affecting statistics or recency
+         * 
+         * @param page_address Address of the first byte of the page
+         * @return Pointer to the cached page, or NULL if it is not cached
+         */
+        Cache_Page_t *lookup(uint32_t page_address);
+
+        Cache_Page_t *_pages;
+
+        int _page_count;
+
+        uint32_t _use_counter;
+
+        Cache_Stats_t _stats;
+};
+
+/** Storage for the pages of an STM24xxx_Fixed_Read_Cache. It is a base class of the cache
+ *  so that it exists before, and outlasts, the read cache using it
+ */
+template<class EEPROM_Type, int PAGE_COUNT>
+class STM24xxx_Read_Cache_Storage
+{
+
+    protected:
+
+        typename STM24xxx_Read_Cache<EEPROM_Type>::Cache_Page_t _storage[PAGE_COUNT];
+};
+
+/** Read cache holding PAGE_COUNT pages within itself, so that its size is fixed at compile
+ *  time and it is allocated wherever it is declared, typically statically
+ */
+template<class EEPROM_Type, int PAGE_COUNT>
+class STM24xxx_Fixed_Read_Cache : private STM24xxx_Read_Cache_Storage<EEPROM_Type, PAGE_COUNT>,
+                                  public STM24xxx_Read_Cache<EEPROM_Type>
+{
+
+    static_assert(PAGE_COUNT > 0, "Read cache must hold at least one page");
+
+    public:
+
+        /** Constructor. Create an empty read cache of PAGE_COUNT pages
+         */
+        STM24xxx_Fixed_Read_Cache() :
+            STM24xxx_Read_Cache<EEPROM_Type>(this->_storage, PAGE_COUNT)
+        {
+
+        }
+};
+
+/** The read cache for each part of the M24xxx family supported by the driver
+ */
+typedef STM24xxx_Read_Cache<STM24C64> STM24C64_Read_Cache;
+typedef STM24xxx_Read_Cache<STM24256> STM24256_Read_Cache;
+typedef STM24xxx_Read_Cache<STM24512> STM24512_Read_Cache;
+typedef STM24xxx_Read_Cache<STM24M01> STM24M01_Read_Cache;
+typedef STM24xxx_Read_Cache<STM24M02> STM24M02_Read_Cache;
+
+/** The fixed-size read cache for each part of the M24xxx family supported by the driver
+ */
+template<int PAGE_COUNT> using STM24C64_Fixed_Read_Cache = STM24xxx_Fixed_Read_Cache<STM24C64, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24256_Fixed_Read_Cache = STM24xxx_Fixed_Read_Cache<STM24256, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24512_Fixed_Read_Cache = STM24xxx_Fixed_Read_Cache<STM24512, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24M01_Fixed_Read_Cache = STM24xxx_Fixed_Read_Cache<STM24M01, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24M02_Fixed_Read_Cache = STM24xxx_Fixed_Read_Cache<STM24M02, PAGE_COUNT>;
@@ -0,0 +1,318 @@
+/**
+  * @file    STM24256_Stripe.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   C++ file of the multi-bus striped volume for the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_Stripe.h"
+
+/** Constructor. Create a striped volume and, where an RTOS is present, start a worker
+ *  thread for each EEPROM but the first
+ * 
+ * @param members Array of member_count EEPROM drivers, each on a different I2C bus.
+ *                At most EEPROM_STRIPE_MAX_MEMBERS are used
+ * @param member_count Amount of EEPROMs in the striped volume
+ * @param verify Decide whether or not written data should be verified. Defaults to true
+ */
+template<class EEPROM_Type>
+STM24xxx_Stripe<EEPROM_Type>::STM24xxx_Stripe(EEPROM_Type **members, int member_count, bool verify) :
+                                              _member_count(member_count),
+                                              _verify(verify)
+{
+    if(_member_count > EEPROM_STRIPE_MAX_MEMBERS)
+    {
+        _member_count = EEPROM_STRIPE_MAX_MEMBERS;
+    }
+
+    /** A negative count would wrap the size of the striped volume, an empty one refuses every
+     *  access
+     */
+    if(_member_count < 0)
+    {
+        _member_count = 0;
+    }
+
+    for(int i = 0; i < _member_count; i++)
+    {
+        _members[i].stripe = this;
+        _members[i].eeprom = members[i];
+        _members[i].index = i;
+        _members[i].status = EEPROM_Type::EEPROM_OK;
+
+#if MBED_CONF_RTOS_PRESENT
+        /** The calling thread services the first EEPROM itself
+         */
+        if(i > 0)
+        {
+            _workers[i].start(callback(&STM24xxx_Stripe::worker, &_members[i]));
+        }
+#endif /* #if MBED_CONF_RTOS_PRESENT */
+    }
+}
+
+/** Destructor. Stop the worker threads and wait for them to finish
+ */
+template<class EEPROM_Type>
+STM24xxx_Stripe<EEPROM_Type>::~STM24xxx_Stripe()
+{
+#if MBED_CONF_RTOS_PRESENT
+    _mutex.lock();
+
+    _operation = EEPROM_STRIPE_STOP;
+
+    for(int i = 1; i < _member_count; i++)
+    {
+        _start[i].release();
+        _workers[i].join();
+    }
+
+    _mutex.unlock();
+#endif /* #if MBED_CONF_RTOS_PRESENT */
+}
+
+#if MBED_CONF_RTOS_PRESENT
+/** Body of the worker thread of an EEPROM, which carries out its share of each
+ *  operation as it is started
+ * 
+ * @param member EEPROM serviced by the worker thread
+ */
+template<class EEPROM_Type>
+void STM24xxx_Stripe<EEPROM_Type>::worker(Stripe_Member_t *member)
+{
+    STM24xxx_Stripe *stripe = member->stripe;
+
+    while(true)
+    {
+        stripe->_start[member->index].acquire();
+
+        if(stripe->_operation == EEPROM_STRIPE_STOP)
+        {
+            return;
+        }
+
+        member->status = stripe->run_member(member->index);
+
+        stripe->_done.release();
+    }
+}
+#endif /* #if MBED_CONF_RTOS_PRESENT */
+
+/** Determine whether or not a slice of the current operation falls on an EEPROM, and
+ *  where within that EEPROM
+ * 
+ * @param index Index of the EEPROM within the striped volume
+ * @param &slice Slice of the current operation
+ * @param &member_address Reference to a uint32_t in which to store the address of the
+ *                        slice within the EEPROM
+ * @return Returns true if the slice falls on the EEPROM
+ */
+template<class EEPROM_Type>
+bool STM24xxx_Stripe<EEPROM_Type>::locate(int index, const Page_Slice &slice, uint32_t &member_address)
+{
+    uint32_t page = slice.address / EEPROM_PAGE_SIZE;
+    if((int)(page % _member_count) != index)
+    {
+        return false;
+    }
+
+    member_address = (page / _member_count) * EEPROM_PAGE_SIZE + (slice.address % EEPROM_PAGE_SIZE);
+
+    return true;
+}
+
+/** Carry out the share of the current operation that falls on one EEPROM
+ * 
+ * @param index Index of the EEPROM within the striped volume
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Stripe<EEPROM_Type>::EEPROM_Status_t STM24xxx_Stripe<EEPROM_Type>::run_member(int index)
+{
+    EEPROM_Type *eeprom = _members[index].eeprom;
+
+    Page_Slicer slicer(_operation_address, _operation_length);
+    Page_Slice slice;
+    uint32_t member_address;
+
+    while(slicer.next(slice))
+    {
+        if(!locate(index, slice, member_address))
+        {
+            continue;
+        }
+
+        EEPROM_Status_t status;
+        if(_operation == EEPROM_STRIPE_READ)
+        {
+            status = eeprom->read_from_address(member_address, &_read_data[slice.offset], slice.length);
+        }
+        else
+        {
+            status = eeprom->program_page(member_address, &_write_data[slice.offset], slice.length);
+        }
+
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            return status;
+        }
+    }
+
+    if(_operation != EEPROM_STRIPE_WRITE)
+    {
+        return EEPROM_Type::EEPROM_OK;
+    }
+
+    EEPROM_Status_t status = eeprom->wait_for_write_cycle();
+    if(status != EEPROM_Type::EEPROM_OK || !_verify)
+    {
+        return status;
+    }
+
+    /** Compare against the EEPROM itself, as program_page does not check what it wrote and an
+     *  attached read cache already holds the data
+     */
+    slicer = Page_Slicer(_operation_address, _operation_length);
+    while(slicer.next(slice))
+    {
+        if(!locate(index, slice, member_address))
+        {
+            continue;
+        }
+
+        status = eeprom->verify_at_address(member_address, &_write_data[slice.offset], slice.length);
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            return status;
+        }
+    }
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Start the current operation on every EEPROM and wait for all of them to finish it
+ * 
+ * @return Status of the first EEPROM to fail, or EEPROM_OK
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Stripe<EEPROM_Type>::EEPROM_Status_t STM24xxx_Stripe<EEPROM_Type>::run_operation()
+{
+#if MBED_CONF_RTOS_PRESENT
+    for(int i = 1; i < _member_count; i++)
+    {
+        _start[i].release();
+    }
+
+    _members[0].status = run_member(0);
+
+    for(int i = 1; i < _member_count; i++)
+    {
+        _done.acquire();
+    }
+#else
+    for(int i = 0; i < _member_count; i++)
+    {
+        _members[i].status = run_member(i);
+    }
+#endif /* #if MBED_CONF_RTOS_PRESENT */
+
+    for(int i = 0; i < _member_count; i++)
+    {
+        if(_members[i].status != EEPROM_Type::EEPROM_OK)
+        {
+            return _members[i].status;
+        }
+    }
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Read data_length bytes from address into data, reading from all EEPROMs at once
+ * 
+ * @param address Address within the striped volume that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Stripe<EEPROM_Type>::EEPROM_Status_t STM24xxx_Stripe<EEPROM_Type>::read_from_address(uint32_t address, char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= get_size() || (uint32_t)data_length > get_size() - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    _operation = EEPROM_STRIPE_READ;
+    _operation_address = address;
+    _operation_length = data_length;
+    _read_data = data;
+
+    EEPROM_Status_t status = run_operation();
+
+    _mutex.unlock();
+
+    return status;
+}
+
+/** Write data_length bytes from data to address, writing to all EEPROMs at once. Returns
+ *  once the write cycles of the final pages have completed and, if verification is
+ *  enabled, every EEPROM has compared its share with the data
+ * 
+ * @param address Address within the striped volume pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Stripe<EEPROM_Type>::EEPROM_Status_t STM24xxx_Stripe<EEPROM_Type>::write_to_address(uint32_t address, const char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= get_size() || (uint32_t)data_length > get_size() - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    _operation = EEPROM_STRIPE_WRITE;
+    _operation_address = address;
+    _operation_length = data_length;
+    _write_data = data;
+
+    EEPROM_Status_t status = run_operation();
+
+    _mutex.unlock();
+
+    return status;
+}
+
+/** Get the size of the striped volume
+ * 
+ * @return Size of the striped volume in bytes
+ */
+template<class EEPROM_Type>
+uint32_t STM24xxx_Stripe<EEPROM_Type>::get_size()
+{
+    return (uint32_t)_member_count * EEPROM_MEM_ARRAY_SIZE;
+}
+
+/** Parts of the M24xxx family for which the striped volume is compiled
+ */
+template class STM24xxx_Stripe<STM24C64>;
+template class STM24xxx_Stripe<STM24256>;
+template class STM24xxx_Stripe<STM24512>;
+template class STM24xxx_Stripe<STM24M01>;
+template class STM24xxx_Stripe<STM24M02>;
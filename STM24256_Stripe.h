@@ -0,0 +1,170 @@
+/**
+  * @file    STM24256_Stripe.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Header file of the multi-bus striped volume for the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+#include "STM24256.h"
+
+/** Maximum amount of EEPROMs, each on its own I2C bus, in a striped volume
+ */
+#define EEPROM_STRIPE_MAX_MEMBERS 4
+
+/** Linear address space striped page by page across identical EEPROMs, each on its own I2C
+ *  bus. A read or write is split into the pages held by each EEPROM, and where an RTOS is
+ *  present every EEPROM but the first is serviced by a worker thread of its own while the
+ *  calling thread services the first, so transfers on the different buses run concurrently and
+ *  sequential throughput scales with the amount of buses. Without an RTOS the EEPROMs are
+ *  serviced one after another. Writes are verified by default, each EEPROM checking its own
+ *  share once its final write cycle has completed
+ */
+template<class EEPROM_Type>
+class STM24xxx_Stripe
+{
+
+    public:
+
+        /** Geometry and types of the EEPROM driver the striped volume is built upon
+         */
+        static constexpr int EEPROM_PAGE_SIZE = EEPROM_Type::EEPROM_PAGE_SIZE;
+        static constexpr int EEPROM_MEM_ARRAY_SIZE = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+        typedef typename EEPROM_Type::EEPROM_Status_t EEPROM_Status_t;
+        typedef typename EEPROM_Type::Page_Slicer Page_Slicer;
+        typedef typename EEPROM_Type::Page_Slice Page_Slice;
+
+        /** Constructor. Create a striped volume and, where an RTOS is present, start a worker
+         *  thread for each EEPROM but the first
+         * 
+         * @param members Array of member_count EEPROM drivers, each on a different I2C bus.
+         *                At most EEPROM_STRIPE_MAX_MEMBERS are used
+         * @param member_count Amount of EEPROMs in the striped volume
+         * @param verify Decide whether or not written data should be verified. Defaults to true
+         */
+        STM24xxx_Stripe(EEPROM_Type **members, int member_count, bool verify = true);
+
+        /** Destructor. Stop the worker threads and wait for them to finish
+         */
+        ~STM24xxx_Stripe();
+
+        /** Read data_length bytes from address into data, reading from all EEPROMs at once
+         * 
+         * @param address Address within the striped volume that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_from_address(uint32_t address, char *data, int data_length);
+
+        /** Write data_length bytes from data to address, writing to all EEPROMs at once. Returns
+         *  once the write cycles of the final pages have completed and, if verification is
+         *  enabled, every EEPROM has compared its share with the data
+         * 
+         * @param address Address within the striped volume pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t write_to_address(uint32_t address, const char *data, int data_length);
+
+        /** Get the size of the striped volume
+         * 
+         * @return Size of the striped volume in bytes
+         */
+        uint32_t get_size();
+
+    private:
+
+        typedef int Stripe_Operation_t;
+
+        enum
+        {
+            EEPROM_STRIPE_READ  = 0,
+            EEPROM_STRIPE_WRITE = 1,
+            EEPROM_STRIPE_STOP  = 2
+        };
+
+        /** An EEPROM of the striped volume and the outcome of its share of the current operation
+         */
+        typedef struct
+        {
+            STM24xxx_Stripe *stripe;
+            EEPROM_Type *eeprom;
+            int index;
+            EEPROM_Status_t status;
+        } Stripe_Member_t;
+
+        /** Start the current operation on every EEPROM and wait for all of them to finish it
+         * 
+         * @return Status of the first EEPROM to fail, or EEPROM_OK
+         */
+        EEPROM_Status_t run_operation();
+
+        /** Determine whether or not a slice of the current operation falls on an EEPROM, and
+         *  where within that EEPROM
+         * 
+         * @param index Index of the EEPROM within the striped volume
+         * @param &slice Slice of the current operation
+         * @param &member_address Reference to a uint32_t in which to store the address of the
+         *                        slice within the EEPROM
+         * @return Returns true if the slice falls on the EEPROM
+         */
+        bool locate(int index, const Page_Slice &slice, uint32_t &member_address);
+
+        /** Carry out the share of the current operation that falls on one EEPROM
+         * 
+         * @param index Index of the EEPROM within the striped volume
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t run_member(int index);
+
+#if MBED_CONF_RTOS_PRESENT
+        /** Body of the worker thread of an EEPROM, which carries out its share of each
+         *  operation as it is started
+         * 
+         * @param member EEPROM serviced by the worker thread
+         */
+        static void worker(Stripe_Member_t *member);
+#endif /* #if MBED_CONF_RTOS_PRESENT */
+
+        Stripe_Member_t _members[EEPROM_STRIPE_MAX_MEMBERS];
+
+        int _member_count;
+
+        bool _verify;
+
+        Stripe_Operation_t _operation;
+
+        uint32_t _operation_address;
+
+        int _operation_length;
+
+        char *_read_data;
+
+        const char *_write_data;
+
+        PlatformMutex _mutex;
+
+#if MBED_CONF_RTOS_PRESENT
+        rtos::Semaphore _start[EEPROM_STRIPE_MAX_MEMBERS];
+
+        rtos::Semaphore _done;
+
+        rtos::Thread _workers[EEPROM_STRIPE_MAX_MEMBERS];
+#endif /* #if MBED_CONF_RTOS_PRESENT */
+};
+
+/** The striped volume for each part of the M24xxx family supported by the driver
+ */
+typedef STM24xxx_Stripe<STM24C64> STM24C64_Stripe;
+typedef STM24xxx_Stripe<STM24256> STM24256_Stripe;
+typedef STM24xxx_Stripe<STM24512> STM24512_Stripe;
+typedef STM24xxx_Stripe<STM24M01> STM24M01_Stripe;
+typedef STM24xxx_Stripe<STM24M02> STM24M02_Stripe;
@@ -0,0 +1,189 @@
+/**
+  * @file    STM24256_Volume.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   C++ file of the multi-chip volume for the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_Volume.h"
+
+/** Constructor. Create a volume spanning several EEPROMs
+ * 
+ * @param chips Array of chip_count EEPROM drivers, each constructed with a distinct
+ *              configuration of the address pins not used to select a bank. At most
+ *              EEPROM_VOLUME_CHIP_LIMIT are used
+ * @param chip_count Amount of EEPROMs in the volume
+ * @param verify Decide whether or not written data should be verified. Defaults to true
+ */
+template<class EEPROM_Type>
+STM24xxx_Volume<EEPROM_Type>::STM24xxx_Volume(EEPROM_Type **chips, int chip_count, bool verify) :
+                                              _chip_count(chip_count),
+                                              _verify(verify)
+{
+    /** Further EEPROMs could only alias those already in the volume
+     */
+    if(_chip_count > EEPROM_VOLUME_CHIP_LIMIT)
+    {
+        _chip_count = EEPROM_VOLUME_CHIP_LIMIT;
+    }
+
+    /** A negative count would wrap the size of the volume, an empty volume refuses every access
+     */
+    if(_chip_count < 0)
+    {
+        _chip_count = 0;
+    }
+
+    for(int i = 0; i < _chip_count; i++)
+    {
+        _chips[i] = chips[i];
+    }
+}
+
+/** Find the EEPROM holding an address within the volume
+ * 
+ * @param address Address within the volume
+ * @param &chip_address Reference to a uint32_t in which to store the address within the EEPROM
+ * @return Pointer to the EEPROM holding the address
+ */
+template<class EEPROM_Type>
+EEPROM_Type *STM24xxx_Volume<EEPROM_Type>::locate(uint32_t address, uint32_t &chip_address)
+{
+    uint32_t page = address / EEPROM_PAGE_SIZE;
+
+    chip_address = (page / _chip_count) * EEPROM_PAGE_SIZE + (address % EEPROM_PAGE_SIZE);
+
+    return _chips[page % _chip_count];
+}
+
+/** Read data_length bytes from address into data
+ * 
+ * @param address Address within the volume that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Volume<EEPROM_Type>::EEPROM_Status_t STM24xxx_Volume<EEPROM_Type>::read_from_address(uint32_t address, char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= get_size() || (uint32_t)data_length > get_size() - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        uint32_t chip_address;
+        EEPROM_Type *chip = locate(slice.address, chip_address);
+
+        /** An EEPROM still busy with a page written to it waits for that write cycle first
+         */
+        EEPROM_Status_t status = chip->read_from_address(chip_address, &data[slice.offset], slice.length);
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            _mutex.unlock();
+            return status;
+        }
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Write data_length bytes from data to address. Each page is handed to its EEPROM without
+ *  waiting for the write cycle of the previous page, which belongs to another EEPROM
+ * 
+ * @param address Address within the volume pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Volume<EEPROM_Type>::EEPROM_Status_t STM24xxx_Volume<EEPROM_Type>::write_to_address(uint32_t address, const char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= get_size() || (uint32_t)data_length > get_size() - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        uint32_t chip_address;
+        EEPROM_Type *chip = locate(slice.address, chip_address);
+
+        /** program_page only waits for the write cycle of the page last written to this EEPROM,
+         *  a whole round of the other EEPROMs ago
+         */
+        EEPROM_Status_t status = chip->program_page(chip_address, &data[slice.offset], slice.length);
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            _mutex.unlock();
+            return status;
+        }
+    }
+
+    if(_verify)
+    {
+        slicer = Page_Slicer(address, data_length);
+        while(slicer.next(slice))
+        {
+            uint32_t chip_address;
+            EEPROM_Type *chip = locate(slice.address, chip_address);
+
+            /** Compare against the EEPROM itself, as a read cache or read-ahead buffer attached to
+             *  it already holds the data just written
+             */
+            EEPROM_Status_t status = chip->verify_at_address(chip_address, &data[slice.offset], slice.length);
+            if(status != EEPROM_Type::EEPROM_OK)
+            {
+                _mutex.unlock();
+                return status;
+            }
+        }
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Get the size of the volume
+ * 
+ * @return Size of the volume in bytes
+ */
+template<class EEPROM_Type>
+uint32_t STM24xxx_Volume<EEPROM_Type>::get_size()
+{
+    return (uint32_t)_chip_count * EEPROM_MEM_ARRAY_SIZE;
+}
+
+/** Parts of the M24xxx family for which the volume is compiled
+ */
+template class STM24xxx_Volume<STM24C64>;
+template class STM24xxx_Volume<STM24256>;
+template class STM24xxx_Volume<STM24512>;
+template class STM24xxx_Volume<STM24M01>;
+template class STM24xxx_Volume<STM24M02>;
@@ -0,0 +1,108 @@
+/**
+  * @file    STM24256_Volume.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Header file of the multi-chip volume for the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+#include "STM24256.h"
+
+/** Maximum amount of EEPROMs in a volume, as selected by the E0, E1 and E2 address pins. Parts
+ *  that select banks with some of those pins allow fewer, see EEPROM_VOLUME_CHIP_LIMIT
+ */
+#define EEPROM_VOLUME_MAX_CHIPS 8
+
+/** Linear address space spanning several identical EEPROMs on one bus. Consecutive pages of
+ *  the volume are interleaved across the EEPROMs, so that while one EEPROM is busy with the
+ *  internal write cycle of a page the next page is already being written to another. The
+ *  write cycles of a sequential write therefore overlap and its throughput scales with the
+ *  amount of EEPROMs in the volume
+ */
+template<class EEPROM_Type>
+class STM24xxx_Volume
+{
+
+    public:
+
+        /** Geometry and types of the EEPROM driver the volume is built upon
+         */
+        static constexpr int EEPROM_PAGE_SIZE = EEPROM_Type::EEPROM_PAGE_SIZE;
+        static constexpr int EEPROM_MEM_ARRAY_SIZE = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+        typedef typename EEPROM_Type::EEPROM_Status_t EEPROM_Status_t;
+        typedef typename EEPROM_Type::Page_Slicer Page_Slicer;
+        typedef typename EEPROM_Type::Page_Slice Page_Slice;
+
+        /** Maximum amount of EEPROMs of this part in a volume. Address pins that select a bank
+         *  cannot also select an EEPROM, leaving 8 for the STM24C64, STM24256 and STM24512, 4 for
+         *  the STM24M01 (E1 and E2) and 2 for the STM24M02 (E2)
+         */
+        static constexpr int EEPROM_VOLUME_CHIP_LIMIT = EEPROM_VOLUME_MAX_CHIPS / EEPROM_Type::EEPROM_BANK_COUNT;
+
+        /** Constructor. Create a volume spanning several EEPROMs
+         * 
+         * @param chips Array of chip_count EEPROM drivers, each constructed with a distinct
+         *              configuration of the address pins not used to select a bank. At most
+         *              EEPROM_VOLUME_CHIP_LIMIT are used
+         * @param chip_count Amount of EEPROMs in the volume
+         * @param verify Decide whether or not written data should be verified. Defaults to true
+         */
+        STM24xxx_Volume(EEPROM_Type **chips, int chip_count, bool verify = true);
+
+        /** Read data_length bytes from address into data
+         * 
+         * @param address Address within the volume that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_from_address(uint32_t address, char *data, int data_length);
+
+        /** Write data_length bytes from data to address. Each page is handed to its EEPROM without
+         *  waiting for the write cycle of the previous page, which belongs to another EEPROM
+         * 
+         * @param address Address within the volume pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t write_to_address(uint32_t address, const char *data, int data_length);
+
+        /** Get the size of the volume
+         * 
+         * @return Size of the volume in bytes
+         */
+        uint32_t get_size();
+
+    private:
+
+        /** Find the EEPROM holding an address within the volume
+         * 
+         * @param address Address within the volume
+         * @param &chip_address Reference to a uint32_t in which to store the address within the EEPROM
+         * @return Pointer to the EEPROM holding the address
+         */
+        EEPROM_Type *locate(uint32_t address, uint32_t &chip_address);
+
+        EEPROM_Type *_chips[EEPROM_VOLUME_CHIP_LIMIT];
+
+        int _chip_count;
+
+        bool _verify;
+
+        PlatformMutex _mutex;
+};
+
+/** The volume for each part of the M24xxx family supported by the driver
+ */
+typedef STM24xxx_Volume<STM24C64> STM24C64_Volume;
+typedef STM24xxx_Volume<STM24256> STM24256_Volume;
+typedef STM24xxx_Volume<STM24512> STM24512_Volume;
+typedef STM24xxx_Volume<STM24M01> STM24M01_Volume;
+typedef STM24xxx_Volume<STM24M02> STM24M02_Volume;
@@ -0,0 +1,407 @@
+/**
+  * @file    STM24256_Write_Back_Cache.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   C++ file of the write-back page cache for the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_Write_Back_Cache.h"
+
+/** Constructor. Create a write-back cache in front of an EEPROM
+ * 
+ * @param eeprom EEPROM driver to cache
+ * @param pages Array of page_count pages to use as the cache
+ * @param page_count Amount of pages in the cache. A cache of no pages programs writes
+ *                   straight through, a page at a time
+ * @param verify Decide whether or not pages should be verified when they are programmed.
+ *               Defaults to true
+ */
+template<class EEPROM_Type>
+STM24xxx_Write_Back_Cache<EEPROM_Type>::STM24xxx_Write_Back_Cache(EEPROM_Type &eeprom, Cache_Page_t *pages, int page_count, bool verify) :
+                                                     _eeprom(eeprom),
+                                                     _pages(pages),
+                                                     _page_count(page_count),
+                                                     _verify(verify),
+                                                     _use_counter(0),
+                                                     _flush_queue(NULL),
+                                                     _flush_event_id(0)
+{
+    if(_pages == NULL || _page_count < 0)
+    {
+        _page_count = 0;
+    }
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        _pages[i].valid = false;
+        _pages[i].dirty = false;
+    }
+}
+
+/** Destructor. Will stop any periodic flush and program all dirty pages
+ */
+template<class EEPROM_Type>
+STM24xxx_Write_Back_Cache<EEPROM_Type>::~STM24xxx_Write_Back_Cache()
+{
+    stop_periodic_flush();
+    flush();
+}
+
+/** Find the cached copy of a page
+ * 
+ * @param page_address Address of the first byte of the page
+ * @return Pointer to the cached page, or NULL if it is not cached
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::Cache_Page_t *STM24xxx_Write_Back_Cache<EEPROM_Type>::find_page(uint32_t page_address)
+{
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(_pages[i].valid && _pages[i].address == page_address)
+        {
+            _pages[i].last_used = ++_use_counter;
+            return &_pages[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** Make room for a page in the cache, evicting the least recently used page if required
+ * 
+ * @param page_address Address of the first byte of the page
+ * @param fill Decide whether or not the page should be read from the EEPROM
+ * @param &page Reference to a pointer in which to store the allocated page
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Back_Cache<EEPROM_Type>::allocate_page(uint32_t page_address, bool fill, Cache_Page_t *&page)
+{
+    Cache_Page_t *victim = &_pages[0];
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(!_pages[i].valid)
+        {
+            victim = &_pages[i];
+            break;
+        }
+
+        if(_pages[i].last_used < victim->last_used)
+        {
+            victim = &_pages[i];
+        }
+    }
+
+    /** A dirty page must be programmed before its slot can be reused
+     */
+    EEPROM_Status_t status = flush_page(victim);
+    if(status != EEPROM_Type::EEPROM_OK)
+    {
+        return status;
+    }
+
+    victim->valid = false;
+
+    /** Bytes of the page that are not about to be overwritten must hold their current contents
+     *  so that the whole page can be programmed when it is flushed
+     */
+    if(fill)
+    {
+        status = _eeprom.read_from_address(page_address, victim->data, EEPROM_PAGE_SIZE);
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            return status;
+        }
+    }
+
+    victim->address = page_address;
+    victim->valid = true;
+    victim->dirty = false;
+    victim->last_used = ++_use_counter;
+
+    page = victim;
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Program a single page into the EEPROM if it is dirty
+ * 
+ * @param page Pointer to the page to program
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Back_Cache<EEPROM_Type>::flush_page(Cache_Page_t *page)
+{
+    if(!page->valid || !page->dirty)
+    {
+        return EEPROM_Type::EEPROM_OK;
+    }
+
+    EEPROM_Status_t status = _eeprom.write_to_address(page->address, page->data, EEPROM_PAGE_SIZE, _verify);
+    if(status != EEPROM_Type::EEPROM_OK)
+    {
+        return status;
+    }
+
+    page->dirty = false;
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Read data_length bytes from address into data. Pages held in the cache are served
+ *  from RAM, only the remainder is read from the EEPROM
+ * 
+ * @param address Address that points to start of data
+ * @param data Char array in which to store retrieved data
+ * @param data_length Amount of data to retrieve in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Back_Cache<EEPROM_Type>::read_from_address(uint32_t address, char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= EEPROM_MEM_ARRAY_SIZE || (uint32_t)data_length > EEPROM_MEM_ARRAY_SIZE - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    /** Only go to the EEPROM if at least one of the pages is not cached, in which case the
+     *  whole range is read in one transaction and cached pages are laid over the top of it
+     */
+    bool all_cached = true;
+    while(slicer.next(slice))
+    {
+        if(find_page(slice.address - (slice.address % EEPROM_PAGE_SIZE)) == NULL)
+        {
+            all_cached = false;
+            break;
+        }
+    }
+
+    if(!all_cached)
+    {
+        EEPROM_Status_t status = _eeprom.read_from_address(address, data, data_length);
+        if(status != EEPROM_Type::EEPROM_OK)
+        {
+            _mutex.unlock();
+            return status;
+        }
+    }
+
+    slicer = Page_Slicer(address, data_length);
+    while(slicer.next(slice))
+    {
+        Cache_Page_t *page = find_page(slice.address - (slice.address % EEPROM_PAGE_SIZE));
+        if(page != NULL)
+        {
+            memcpy(&data[slice.offset], &page->data[slice.address % EEPROM_PAGE_SIZE], slice.length);
+        }
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Write data_length bytes from data to address in the cache. The data is not programmed
+ *  into the EEPROM until the pages it falls within are flushed, unless the cache has no
+ *  pages. As whole pages are always programmed, data_length need not be even
+ * 
+ * @param address Address pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Back_Cache<EEPROM_Type>::write_to_address(uint32_t address, const char *data, int data_length)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= EEPROM_MEM_ARRAY_SIZE || (uint32_t)data_length > EEPROM_MEM_ARRAY_SIZE - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+    Cache_Page_t through;
+
+    while(slicer.next(slice))
+    {
+        uint32_t page_address = slice.address - (slice.address % EEPROM_PAGE_SIZE);
+        EEPROM_Status_t status;
+
+        Cache_Page_t *page = find_page(page_address);
+        if(page == NULL && _page_count == 0)
+        {
+            /** A cache of no pages has nowhere to hold the data, so each page is assembled on
+             *  the stack and programmed straight through
+             */
+            if(slice.length != EEPROM_PAGE_SIZE)
+            {
+                status = _eeprom.read_from_address(page_address, through.data, EEPROM_PAGE_SIZE);
+                if(status != EEPROM_Type::EEPROM_OK)
+                {
+                    _mutex.unlock();
+                    return status;
+                }
+            }
+
+            through.address = page_address;
+            through.valid = true;
+            page = &through;
+        }
+        else if(page == NULL)
+        {
+            /** A page that is about to be overwritten entirely need not be read first
+             */
+            status = allocate_page(page_address, slice.length != EEPROM_PAGE_SIZE, page);
+            if(status != EEPROM_Type::EEPROM_OK)
+            {
+                _mutex.unlock();
+                return status;
+            }
+        }
+
+        memcpy(&page->data[slice.address % EEPROM_PAGE_SIZE], &data[slice.offset], slice.length);
+        page->dirty = true;
+
+        if(page == &through)
+        {
+            status = flush_page(page);
+            if(status != EEPROM_Type::EEPROM_OK)
+            {
+                _mutex.unlock();
+                return status;
+            }
+        }
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Program every dirty page into the EEPROM
+ * 
+ * @return Indicates success or failure reason. Pages that fail to program remain dirty
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Back_Cache<EEPROM_Type>::flush()
+{
+    EEPROM_Status_t result = EEPROM_Type::EEPROM_OK;
+
+    _mutex.lock();
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        EEPROM_Status_t status = flush_page(&_pages[i]);
+        if(status != EEPROM_Type::EEPROM_OK && result == EEPROM_Type::EEPROM_OK)
+        {
+            result = status;
+        }
+    }
+
+    _mutex.unlock();
+
+    return result;
+}
+
+/** Flush the cache every period_ms from an event queue dispatched by the application
+ * 
+ * @param queue Pointer to the event queue to flush from
+ * @param period_ms Interval between flushes in milliseconds
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Back_Cache<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Back_Cache<EEPROM_Type>::start_periodic_flush(events::EventQueue *queue, int period_ms)
+{
+    if(queue == NULL)
+    {
+        return EEPROM_Type::EEPROM_NO_EVENT_QUEUE;
+    }
+
+    stop_periodic_flush();
+
+    _flush_event_id = queue->call_every(period_ms, callback(this, &STM24xxx_Write_Back_Cache::periodic_flush));
+    if(_flush_event_id == 0)
+    {
+        return EEPROM_Type::EEPROM_BUSY;
+    }
+
+    _flush_queue = queue;
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Stop flushing the cache periodically
+ */
+template<class EEPROM_Type>
+void STM24xxx_Write_Back_Cache<EEPROM_Type>::stop_periodic_flush()
+{
+    if(_flush_queue != NULL)
+    {
+        _flush_queue->cancel(_flush_event_id);
+        _flush_queue = NULL;
+        _flush_event_id = 0;
+    }
+}
+
+/** Flush the cache from the event queue
+ */
+template<class EEPROM_Type>
+void STM24xxx_Write_Back_Cache<EEPROM_Type>::periodic_flush()
+{
+    /** Pages that fail to program remain dirty and will be retried on the next flush
+     */
+    flush();
+}
+
+/** Determine how many pages in the cache have yet to be programmed into the EEPROM
+ * 
+ * @return Amount of dirty pages
+ */
+template<class EEPROM_Type>
+int STM24xxx_Write_Back_Cache<EEPROM_Type>::get_dirty_page_count()
+{
+    int dirty = 0;
+
+    _mutex.lock();
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(_pages[i].valid && _pages[i].dirty)
+        {
+            dirty++;
+        }
+    }
+
+    _mutex.unlock();
+
+    return dirty;
+}
+
+/** Parts of the M24xxx family for which the cache is compiled
+ */
+template class STM24xxx_Write_Back_Cache<STM24C64>;
+template class STM24xxx_Write_Back_Cache<STM24256>;
+template class STM24xxx_Write_Back_Cache<STM24512>;
+template class STM24xxx_Write_Back_Cache<STM24M01>;
+template class STM24xxx_Write_Back_Cache<STM24M02>;
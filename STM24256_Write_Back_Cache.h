@@ -0,0 +1,209 @@
+/**
+  * @file    STM24256_Write_Back_Cache.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Header file of the write-back page cache for the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+#include "STM24256.h"
+
+/** RAM write-back cache of EEPROM pages. Writes are gathered into cached copies of the pages
+ *  they fall within and only programmed into the EEPROM when the cache is flushed, either
+ *  explicitly, periodically from an event queue or when a dirty page has to be evicted to
+ *  make room for another. Repeated writes to the same page therefore cost a single page
+ *  program cycle, and reads of cached pages are served from RAM. The pages are either
+ *  provided by the application or, with STM24xxx_Fixed_Write_Back_Cache, held within the
+ *  cache itself
+ */
+template<class EEPROM_Type>
+class STM24xxx_Write_Back_Cache
+{
+
+    public:
+
+        /** Geometry and types of the EEPROM driver the cache is built upon
+         */
+        static constexpr int EEPROM_PAGE_SIZE = EEPROM_Type::EEPROM_PAGE_SIZE;
+        static constexpr int EEPROM_MEM_ARRAY_SIZE = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+        typedef typename EEPROM_Type::EEPROM_Status_t EEPROM_Status_t;
+        typedef typename EEPROM_Type::Page_Slicer Page_Slicer;
+        typedef typename EEPROM_Type::Page_Slice Page_Slice;
+
+        /** A single cached page. Storage for these is provided by the application, or by
+         *  STM24xxx_Fixed_Write_Back_Cache whose page count is a template parameter
+         */
+        typedef struct
+        {
+            uint32_t address;
+            bool valid;
+            bool dirty;
+            uint32_t last_used;
+            char data[EEPROM_PAGE_SIZE];
+        } Cache_Page_t;
+
+        /** Constructor. Create a write-back cache in front of an EEPROM
+         * 
+         * @param eeprom EEPROM driver to cache
+         * @param pages Array of page_count pages to use as the cache
+         * @param page_count Amount of pages in the cache. A cache of no pages programs writes
+         *                   straight through, a page at a time
+         * @param verify Decide whether or not pages should be verified when they are programmed.
+         *               Defaults to true
+         */
+        STM24xxx_Write_Back_Cache(EEPROM_Type &eeprom, Cache_Page_t *pages, int page_count, bool verify = true);
+
+        /** Destructor. Will stop any periodic flush and program all dirty pages
+         */
+        ~STM24xxx_Write_Back_Cache();
+
+        /** Read data_length bytes from address into data. Pages held in the cache are served
+         *  from RAM, only the remainder is read from the EEPROM
+         * 
+         * @param address Address that points to start of data
+         * @param data Char array in which to store retrieved data
+         * @param data_length Amount of data to retrieve in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t read_from_address(uint32_t address, char *data, int data_length);
+
+        /** Write data_length bytes from data to address in the cache. The data is not programmed
+         *  into the EEPROM until the pages it falls within are flushed, unless the cache has no
+         *  pages. As whole pages are always programmed, data_length need not be even
+         * 
+         * @param address Address pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t write_to_address(uint32_t address, const char *data, int data_length);
+
+        /** Program every dirty page into the EEPROM
+         * 
+         * @return Indicates success or failure reason. Pages that fail to program remain dirty
+         */
+        EEPROM_Status_t flush();
+
+        /** Flush the cache every period_ms from an event queue dispatched by the application
+         * 
+         * @param queue Pointer to the event queue to flush from
+         * @param period_ms Interval between flushes in milliseconds
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t start_periodic_flush(events::EventQueue *queue, int period_ms);
+
+        /** Stop flushing the cache periodically
+         */
+        void stop_periodic_flush();
+
+        /** Determine how many pages in the cache have yet to be programmed into the EEPROM
+         * 
+         * @return Amount of dirty pages
+         */
+        int get_dirty_page_count();
+
+    private:
+
+        /** Find the cached copy of a page
+         * 
+         * @param page_address Address of the first byte of the page
+         * @return Pointer to the cached page, or NULL if it is not cached
+         */
+        Cache_Page_t *find_page(uint32_t page_address);
+
+        /** Make room for a page in the cache, evicting the least recently used page if required
+         * 
+         * @param page_address Address of the first byte of the page
+         * @param fill Decide whether or not the page should be read from the EEPROM
+         * @param &page Reference to a pointer in which to store the allocated page
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t allocate_page(uint32_t page_address, bool fill, Cache_Page_t *&page);
+
+        /** Program a single page into the EEPROM if it is dirty
+         * 
+         * @param page Pointer to the page to program
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t flush_page(Cache_Page_t *page);
+
+        /** Flush the cache from the event queue
+         */
+        void periodic_flush();
+
+        EEPROM_Type &_eeprom;
+
+        Cache_Page_t *_pages;
+
+        int _page_count;
+
+        bool _verify;
+
+        uint32_t _use_counter;
+
+        PlatformMutex _mutex;
+
+        events::EventQueue *_flush_queue;
+
+        int _flush_event_id;
+};
+
+/** The write-back cache for each part of the M24xxx family supported by the driver
+ */
+typedef STM24xxx_Write_Back_Cache<STM24C64> STM24C64_Write_Back_Cache;
+typedef STM24xxx_Write_Back_Cache<STM24256> STM24256_Write_Back_Cache;
+typedef STM24xxx_Write_Back_Cache<STM24512> STM24512_Write_Back_Cache;
+typedef STM24xxx_Write_Back_Cache<STM24M01> STM24M01_Write_Back_Cache;
+typedef STM24xxx_Write_Back_Cache<STM24M02> STM24M02_Write_Back_Cache;
+
+/** Storage for the pages of an STM24xxx_Fixed_Write_Back_Cache. It is a base class of the
+ *  cache so that it exists before, and outlasts, the write-back cache using it, whose
+ *  destructor flushes the pages
+ */
+template<class EEPROM_Type, int PAGE_COUNT>
+class STM24xxx_Write_Back_Cache_Storage
+{
+
+    protected:
+
+        typename STM24xxx_Write_Back_Cache<EEPROM_Type>::Cache_Page_t _storage[PAGE_COUNT];
+};
+
+/** Write-back cache holding PAGE_COUNT pages within itself, so that its size is fixed at
+ *  compile time and it is allocated wherever it is declared
+ */
+template<class EEPROM_Type, int PAGE_COUNT>
+class STM24xxx_Fixed_Write_Back_Cache : private STM24xxx_Write_Back_Cache_Storage<EEPROM_Type, PAGE_COUNT>,
+                                        public STM24xxx_Write_Back_Cache<EEPROM_Type>
+{
+
+    static_assert(PAGE_COUNT > 0, "Write-back cache must hold at least one page");
+
+    public:
+
+        /** Constructor. Create a write-back cache of PAGE_COUNT pages in front of an EEPROM
+         * 
+         * @param eeprom EEPROM driver to cache
+         * @param verify Decide whether or not pages should be verified when they are programmed.
+         *               Defaults to true
+         */
+        STM24xxx_Fixed_Write_Back_Cache(EEPROM_Type &eeprom, bool verify = true) :
+            STM24xxx_Write_Back_Cache<EEPROM_Type>(eeprom, this->_storage, PAGE_COUNT, verify)
+        {
+
+        }
+};
+
+/** The fixed-size write-back cache for each part of the M24xxx family supported by the driver
+ */
+template<int PAGE_COUNT> using STM24C64_Fixed_Write_Back_Cache = STM24xxx_Fixed_Write_Back_Cache<STM24C64, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24256_Fixed_Write_Back_Cache = STM24xxx_Fixed_Write_Back_Cache<STM24256, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24512_Fixed_Write_Back_Cache = STM24xxx_Fixed_Write_Back_Cache<STM24512, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24M01_Fixed_Write_Back_Cache = STM24xxx_Fixed_Write_Back_Cache<STM24M01, PAGE_COUNT>;
+template<int PAGE_COUNT> using STM24M02_Fixed_Write_Back_Cache = STM24xxx_Fixed_Write_Back_Cache<STM24M02, PAGE_COUNT>;
@@ -0,0 +1,371 @@
+/**
+  * @file    STM24256_Write_Queue.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   C++ file of the write coalescing queue for the STM24256 EEPROM driver module
+  */
+
+/** Includes
+ */
+#include "STM24256_Write_Queue.h"
+
+/** Constructor. Create an empty write queue in front of an EEPROM. Storage for pages and
+ *  entries is provided by the application, typically as statically allocated arrays
+ * 
+ * @param eeprom EEPROM driver to write to
+ * @param pages Array of page_count pages in which to gather writes, at most
+ *              EEPROM_WRITE_QUEUE_MAX_PAGES are used
+ * @param page_count Amount of pages that may be gathered at once. A queue of no pages, or
+ *                   of no entries, queues nothing and refuses every write with EEPROM_BUSY
+ * @param entries Array of entry_count entries in which to track queued writes
+ * @param entry_count Amount of writes that may be queued at once
+ * @param verify Decide whether or not pages should be verified when they are programmed.
+ *               Defaults to true
+ */
+template<class EEPROM_Type>
+STM24xxx_Write_Queue<EEPROM_Type>::STM24xxx_Write_Queue(EEPROM_Type &eeprom, Queue_Page_t *pages, int page_count, 
+                                           Queue_Entry_t *entries, int entry_count, bool verify) :
+                                           _eeprom(eeprom),
+                                           _pages(pages),
+                                           _page_count(page_count),
+                                           _entries(entries),
+                                           _entry_count(entry_count),
+                                           _verify(verify)
+{
+    if(_pages == NULL || _page_count < 0)
+    {
+        _page_count = 0;
+    }
+
+    if(_entries == NULL || _entry_count < 0)
+    {
+        _entry_count = 0;
+    }
+
+    /** Each entry records the pages it was merged into as a bit mask
+     */
+    if(_page_count > EEPROM_WRITE_QUEUE_MAX_PAGES)
+    {
+        _page_count = EEPROM_WRITE_QUEUE_MAX_PAGES;
+    }
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        _pages[i].valid = false;
+    }
+
+    for(int i = 0; i < _entry_count; i++)
+    {
+        _entries[i].valid = false;
+        _entries[i].complete = false;
+    }
+}
+
+/** Find the page gathering writes to a given page address
+ * 
+ * @param page_address Address of the first byte of the page
+ * @return Index of the page within the queue, or -1 if it is not being gathered
+ */
+template<class EEPROM_Type>
+int STM24xxx_Write_Queue<EEPROM_Type>::find_page(uint32_t page_address)
+{
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(_pages[i].valid && _pages[i].address == page_address)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** Determine whether or not a byte of a gathered page has been written to
+ * 
+ * @param page Pointer to the page
+ * @param offset Offset of the byte within the page
+ * @return Returns true if the byte is to be programmed
+ */
+template<class EEPROM_Type>
+bool STM24xxx_Write_Queue<EEPROM_Type>::is_dirty(const Queue_Page_t *page, int offset)
+{
+    return page->dirty_mask[offset / 32] & ((uint32_t)1 << (offset % 32));
+}
+
+/** Queue a write of data_length bytes from data to address. The data is copied into the
+ *  queue, so the caller's buffer may be reused immediately. As pages are filled from the
+ *  EEPROM when they are programmed, data_length need not be even
+ * 
+ * @param address Address pointing to where the write operation will begin
+ * @param data Char array storing data to be written
+ * @param data_length Amount of data to write in bytes
+ * @param on_complete Function to invoke with the status of this write once it has been
+ *                    programmed, may be NULL
+ * @return Indicates whether the write was queued. EEPROM_BUSY indicates that the queue
+ *         is full and must be processed first
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Queue<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Queue<EEPROM_Type>::submit(uint32_t address, const char *data, int data_length, 
+                                                       EEPROM_Callback_t on_complete)
+{
+    if(data_length <= 0)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_ZERO;
+    }
+
+    if(address >= EEPROM_MEM_ARRAY_SIZE || (uint32_t)data_length > EEPROM_MEM_ARRAY_SIZE - address)
+    {
+        return EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG;
+    }
+
+    _mutex.lock();
+
+    Queue_Entry_t *entry = NULL;
+    for(int i = 0; i < _entry_count; i++)
+    {
+        if(!_entries[i].valid)
+        {
+            entry = &_entries[i];
+            break;
+        }
+    }
+
+    /** Make sure that the whole write can be queued before merging any of it, so that a
+     *  write is never partially queued
+     */
+    int free_pages = 0;
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(!_pages[i].valid)
+        {
+            free_pages++;
+        }
+    }
+
+    Page_Slicer slicer(address, data_length);
+    Page_Slice slice;
+
+    while(slicer.next(slice))
+    {
+        if(find_page(slice.address - (slice.address % EEPROM_PAGE_SIZE)) == -1)
+        {
+            free_pages--;
+        }
+    }
+
+    if(entry == NULL || free_pages < 0)
+    {
+        _mutex.unlock();
+        return EEPROM_Type::EEPROM_BUSY;
+    }
+
+    entry->valid = true;
+    entry->complete = false;
+    entry->page_mask = 0;
+    entry->on_complete = on_complete;
+
+    slicer = Page_Slicer(address, data_length);
+    while(slicer.next(slice))
+    {
+        uint32_t page_address = slice.address - (slice.address % EEPROM_PAGE_SIZE);
+
+        int index = find_page(page_address);
+        if(index == -1)
+        {
+            for(index = 0; _pages[index].valid; index++)
+            {
+
+            }
+
+            _pages[index].address = page_address;
+            _pages[index].valid = true;
+            memset(_pages[index].dirty_mask, 0, sizeof(_pages[index].dirty_mask));
+        }
+
+        int offset = slice.address % EEPROM_PAGE_SIZE;
+
+        memcpy(&_pages[index].data[offset], &data[slice.offset], slice.length);
+
+        /** Writes are merged in submission order, so later writes to the same bytes win
+         */
+        for(int i = offset; i < offset + slice.length; i++)
+        {
+            _pages[index].dirty_mask[i / 32] |= (uint32_t)1 << (i % 32);
+        }
+
+        entry->page_mask |= (uint32_t)1 << index;
+    }
+
+    _mutex.unlock();
+
+    return EEPROM_Type::EEPROM_OK;
+}
+
+/** Program the dirty bytes of a single gathered page into the EEPROM, reading any clean
+ *  bytes between them first so that one contiguous, even length write can be made
+ * 
+ * @param page Pointer to the page to program
+ * @return Indicates success or failure reason
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Queue<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Queue<EEPROM_Type>::program_page(Queue_Page_t *page)
+{
+    int start = 0;
+    while(!is_dirty(page, start))
+    {
+        start++;
+    }
+
+    int end = EEPROM_PAGE_SIZE;
+    while(!is_dirty(page, end - 1))
+    {
+        end--;
+    }
+
+    /** The driver only accepts even length writes, pages are an even size and aligned so
+     *  widening the span never crosses a page boundary
+     */
+    start &= ~1;
+    end += end & 1;
+
+    /** Any byte within the span that was not written must be rewritten with its current value
+     */
+    for(int i = start; i < end; i++)
+    {
+        if(!is_dirty(page, i))
+        {
+            char current[EEPROM_PAGE_SIZE];
+
+            EEPROM_Status_t status = _eeprom.read_from_address(page->address + start, current, end - start);
+            if(status != EEPROM_Type::EEPROM_OK)
+            {
+                return status;
+            }
+
+            for(int j = start; j < end; j++)
+            {
+                if(!is_dirty(page, j))
+                {
+                    page->data[j] = current[j - start];
+                }
+            }
+
+            break;
+        }
+    }
+
+    return _eeprom.write_to_address(page->address + start, &page->data[start], end - start, _verify);
+}
+
+/** Program every page gathered by the queue, one program cycle per page, then notify each
+ *  queued write of its status and empty the queue
+ * 
+ * @return Indicates success or the first failure reason encountered
+ */
+template<class EEPROM_Type>
+typename STM24xxx_Write_Queue<EEPROM_Type>::EEPROM_Status_t STM24xxx_Write_Queue<EEPROM_Type>::process()
+{
+    EEPROM_Status_t result = EEPROM_Type::EEPROM_OK;
+    EEPROM_Status_t page_status[EEPROM_WRITE_QUEUE_MAX_PAGES] = {EEPROM_Type::EEPROM_OK};
+
+    _mutex.lock();
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        if(!_pages[i].valid)
+        {
+            continue;
+        }
+
+        page_status[i] = program_page(&_pages[i]);
+        if(page_status[i] != EEPROM_Type::EEPROM_OK && result == EEPROM_Type::EEPROM_OK)
+        {
+            result = page_status[i];
+        }
+    }
+
+    /** A write succeeded only if every page it was merged into was programmed
+     */
+    for(int i = 0; i < _entry_count; i++)
+    {
+        if(!_entries[i].valid)
+        {
+            continue;
+        }
+
+        _entries[i].status = EEPROM_Type::EEPROM_OK;
+
+        for(int index = 0; index < _page_count; index++)
+        {
+            if((_entries[i].page_mask & ((uint32_t)1 << index)) && page_status[index] != EEPROM_Type::EEPROM_OK)
+            {
+                _entries[i].status = page_status[index];
+                break;
+            }
+        }
+
+        _entries[i].complete = true;
+    }
+
+    for(int i = 0; i < _page_count; i++)
+    {
+        _pages[i].valid = false;
+    }
+
+    /** The queue is empty before any callbacks are invoked, so that they may submit new writes
+     */
+    for(int i = 0; i < _entry_count; i++)
+    {
+        if(!_entries[i].complete)
+        {
+            continue;
+        }
+
+        EEPROM_Callback_t on_complete = _entries[i].on_complete;
+        EEPROM_Status_t status = _entries[i].status;
+
+        _entries[i].complete = false;
+        _entries[i].valid = false;
+
+        if(on_complete)
+        {
+            on_complete(status);
+        }
+    }
+
+    _mutex.unlock();
+
+    return result;
+}
+
+/** Determine how many writes are waiting to be processed
+ * 
+ * @return Amount of queued writes
+ */
+template<class EEPROM_Type>
+int STM24xxx_Write_Queue<EEPROM_Type>::get_pending_count()
+{
+    int pending = 0;
+
+    _mutex.lock();
+
+    for(int i = 0; i < _entry_count; i++)
+    {
+        if(_entries[i].valid)
+        {
+            pending++;
+        }
+    }
+
+    _mutex.unlock();
+
+    return pending;
+}
+
+/** Parts of the M24xxx family for which the queue is compiled
+ */
+template class STM24xxx_Write_Queue<STM24C64>;
+template class STM24xxx_Write_Queue<STM24256>;
+template class STM24xxx_Write_Queue<STM24512>;
+template class STM24xxx_Write_Queue<STM24M01>;
+template class STM24xxx_Write_Queue<STM24M02>;
@@ -0,0 +1,152 @@
+/**
+  * @file    STM24256_Write_Queue.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Header file of the write coalescing queue for the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes 
+ */
+#include <mbed.h>
+#include "STM24256.h"
+
+/** Maximum amount of pages a write queue can gather at once
+ */
+#define EEPROM_WRITE_QUEUE_MAX_PAGES 32
+
+/** Submission queue that gathers small, independent writes and merges those landing in the
+ *  same page, so that when the queue is processed each dirty page costs a single program
+ *  cycle regardless of how many writes it received. Every submitted write is still notified
+ *  of its own completion status. Queued data is not visible to reads until it is processed
+ */
+template<class EEPROM_Type>
+class STM24xxx_Write_Queue
+{
+
+    public:
+
+        /** Geometry and types of the EEPROM driver the queue is built upon
+         */
+        static constexpr int EEPROM_PAGE_SIZE = EEPROM_Type::EEPROM_PAGE_SIZE;
+        static constexpr int EEPROM_MEM_ARRAY_SIZE = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+        typedef typename EEPROM_Type::EEPROM_Status_t EEPROM_Status_t;
+        typedef typename EEPROM_Type::EEPROM_Callback_t EEPROM_Callback_t;
+        typedef typename EEPROM_Type::Page_Slicer Page_Slicer;
+        typedef typename EEPROM_Type::Page_Slice Page_Slice;
+
+        /** A page gathering queued writes
+         */
+        typedef struct
+        {
+            uint32_t address;
+            bool valid;
+            uint32_t dirty_mask[(EEPROM_PAGE_SIZE + 31) / 32];
+            char data[EEPROM_PAGE_SIZE];
+        } Queue_Page_t;
+
+        /** A queued write awaiting completion, and the pages it was merged into
+         */
+        typedef struct
+        {
+            bool valid;
+            bool complete;
+            uint32_t page_mask;
+            EEPROM_Status_t status;
+            EEPROM_Callback_t on_complete;
+        } Queue_Entry_t;
+
+        /** Constructor. Create an empty write queue in front of an EEPROM. Storage for pages and
+         *  entries is provided by the application, typically as statically allocated arrays
+         * 
+         * @param eeprom EEPROM driver to write to
+         * @param pages Array of page_count pages in which to gather writes, at most
+         *              EEPROM_WRITE_QUEUE_MAX_PAGES are used
+         * @param page_count Amount of pages that may be gathered at once. A queue of no pages, or
+         *                   of no entries, queues nothing and refuses every write with EEPROM_BUSY
+         * @param entries Array of entry_count entries in which to track queued writes
+         * @param entry_count Amount of writes that may be queued at once
+         * @param verify Decide whether or not pages should be verified when they are programmed.
+         *               Defaults to true
+         */
+        STM24xxx_Write_Queue(EEPROM_Type &eeprom, Queue_Page_t *pages, int page_count, 
+                             Queue_Entry_t *entries, int entry_count, bool verify = true);
+
+        /** Queue a write of data_length bytes from data to address. The data is copied into the
+         *  queue, so the caller's buffer may be reused immediately. As pages are filled from the
+         *  EEPROM when they are programmed, data_length need not be even
+         * 
+         * @param address Address pointing to where the write operation will begin
+         * @param data Char array storing data to be written
+         * @param data_length Amount of data to write in bytes
+         * @param on_complete Function to invoke with the status of this write once it has been
+         *                    programmed, may be NULL
+         * @return Indicates whether the write was queued. EEPROM_BUSY indicates that the queue
+         *         is full and must be processed first
+         */
+        EEPROM_Status_t submit(uint32_t address, const char *data, int data_length, 
+                                         EEPROM_Callback_t on_complete = NULL);
+
+        /** Program every page gathered by the queue, one program cycle per page, then notify each
+         *  queued write of its status and empty the queue
+         * 
+         * @return Indicates success or the first failure reason encountered
+         */
+        EEPROM_Status_t process();
+
+        /** Determine how many writes are waiting to be processed
+         * 
+         * @return Amount of queued writes
+         */
+        int get_pending_count();
+
+    private:
+
+        /** Find the page gathering writes to a given page address
+         * 
+         * @param page_address Address of the first byte of the page
+         * @return Index of the page within the queue, or -1 if it is not being gathered
+         */
+        int find_page(uint32_t page_address);
+
+        /** Determine whether or not a byte of a gathered page has been written to
+         * 
+         * @param page Pointer to the page
+         * @param offset Offset of the byte within the page
+         * @return Returns true if the byte is to be programmed
+         */
+        bool is_dirty(const Queue_Page_t *page, int offset);
+
+        /** Program the dirty bytes of a single gathered page into the EEPROM, reading any clean
+         *  bytes between them first so that one contiguous, even length write can be made
+         * 
+         * @param page Pointer to the page to program
+         * @return Indicates success or failure reason
+         */
+        EEPROM_Status_t program_page(Queue_Page_t *page);
+
+        EEPROM_Type &_eeprom;
+
+        Queue_Page_t *_pages;
+
+        int _page_count;
+
+        Queue_Entry_t *_entries;
+
+        int _entry_count;
+
+        bool _verify;
+
+        PlatformMutex _mutex;
+};
+
+/** The write queue for each part of the M24xxx family supported by the driver
+ */
+typedef STM24xxx_Write_Queue<STM24C64> STM24C64_Write_Queue;
+typedef STM24xxx_Write_Queue<STM24256> STM24256_Write_Queue;
+typedef STM24xxx_Write_Queue<STM24512> STM24512_Write_Queue;
+typedef STM24xxx_Write_Queue<STM24M01> STM24M01_Write_Queue;
+typedef STM24xxx_Write_Queue<STM24M02> STM24M02_Write_Queue;
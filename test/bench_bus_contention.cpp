@@ -0,0 +1,98 @@
+/**
+  * @file    bench_bus_contention.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host benchmark of how long another user of the I2C bus waits while the EEPROM is written
+  */
+
+/** Includes
+ */
+#include <algorithm>
+#include "STM24256.h"
+
+/** Another device on the bus asks for it this often throughout the write
+ */
+static const int REQUEST_INTERVAL_US = 100;
+
+/** Report the waits of a bus user requesting the bus every REQUEST_INTERVAL_US between
+ *  start_us and end_us. A request made while the bus is held waits until it is released
+ */
+static void report(const char *name, uint64_t start_us, uint64_t end_us)
+{
+    std::vector<sim::Hold> holds = sim::bus_holds(PB_7);
+
+    uint64_t longest_hold_us = 0;
+    for(const sim::Hold &hold : holds)
+    {
+        if(hold.end_us - hold.start_us > longest_hold_us)
+        {
+            longest_hold_us = hold.end_us - hold.start_us;
+        }
+    }
+
+    std::vector<uint64_t> waits_us;
+    uint64_t total_wait_us = 0;
+
+    for(uint64_t request_us = start_us; request_us < end_us; request_us += REQUEST_INTERVAL_US)
+    {
+        uint64_t wait_us = 0;
+        for(const sim::Hold &hold : holds)
+        {
+            if(request_us >= hold.start_us && request_us < hold.end_us)
+            {
+                wait_us = hold.end_us - request_us;
+                break;
+            }
+        }
+
+        waits_us.push_back(wait_us);
+        total_wait_us += wait_us;
+    }
+
+    std::sort(waits_us.begin(), waits_us.end());
+
+    printf("%-28s %9.1f %12llu %10.1f %10llu %10llu\n", name, (end_us - start_us) / 1000.0,
+           (unsigned long long)longest_hold_us, (double)total_wait_us / waits_us.size(),
+           (unsigned long long)waits_us[waits_us.size() * 99 / 100], (unsigned long long)waits_us.back());
+}
+
+int main()
+{
+    sim::Chip chip;
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+
+    /** A second master on the same bus, used to hold it as the driver once did
+     */
+    I2C bus(PB_7, PB_6);
+
+    char data[1024];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 3 + 5);
+    }
+
+    printf("bench_bus_contention: 1 KB verified write at 400 kHz, tWR %d us, another bus user every %d us\n",
+           chip.twr_us, REQUEST_INTERVAL_US);
+    printf("%-28s %9s %12s %10s %10s %10s\n", "", "write ms", "max hold us", "mean wait", "p99 wait", "max wait");
+
+    /** Before: the bus is held across every write cycle and the whole operation
+     */
+    sim::reset();
+    sim::chips.push_back(&chip);
+    uint64_t start_us = sim::now_us;
+    bus.lock();
+    eeprom.write_to_address(0, data, sizeof(data));
+    bus.unlock();
+    report("bus held for whole write", start_us, sim::now_us);
+
+    /** After: the bus is released while the EEPROM is busy with each write cycle
+     */
+    sim::reset();
+    sim::chips.push_back(&chip);
+    start_us = sim::now_us;
+    eeprom.write_to_address(0, data, sizeof(data));
+    report("bus released during tWR", start_us, sim::now_us);
+
+    return 0;
+}
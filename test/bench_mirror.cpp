@@ -0,0 +1,73 @@
+/**
+  * @file    bench_mirror.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host benchmark of STM24xxx_Mirror write latency against a single verified EEPROM
+  */
+
+/** Includes
+ */
+#include "STM24256.h"
+#include "STM24256_Mirror.h"
+
+/** Amount of data written in each measurement, a whole number of mirror pages
+ */
+static const int DATA_SIZE = 128 * STM24256_Mirror::EEPROM_MIRROR_PAGE_DATA_SIZE;
+
+int main()
+{
+    static char data[DATA_SIZE];
+    for(int i = 0; i < DATA_SIZE; i++)
+    {
+        data[i] = (char)(i * 7 + 3);
+    }
+
+    static sim::Chip chips[2];
+    chips[1].devsel = 0xA2;
+
+    printf("bench_mirror: %d KB written and verified, on one bus; tWR %d us\n",
+           DATA_SIZE / 1024, chips[0].twr_us);
+    printf("%10s %12s %12s %12s %8s\n", "bus Hz", "single ms", "mirror ms", "rewrite ms", "ratio");
+
+    const int frequencies[] = {400000, 1000000};
+
+    for(int frequency : frequencies)
+    {
+        sim::reset();
+        sim::chips.push_back(&chips[0]);
+        sim::chips.push_back(&chips[1]);
+
+        STM24256 primary(PA_0, PB_7, PB_6, frequency, 0);
+        STM24256 secondary(PA_0, PB_7, PB_6, frequency, 1);
+
+        uint64_t start_us = sim::now_us;
+        if(primary.write_to_address(0, data, DATA_SIZE) != STM24256::EEPROM_OK)
+        {
+            printf("bench_mirror: single write failed\n");
+            return 1;
+        }
+        double single_ms = (sim::now_us - start_us) / 1000.0;
+
+        /** The first write to the mirror finds nothing known of its pages, the second finds
+         *  them consistent and takes their sequence numbers from memory
+         */
+        STM24256_Mirror mirror(primary, secondary);
+
+        double mirror_ms[2];
+        for(int pass = 0; pass < 2; pass++)
+        {
+            start_us = sim::now_us;
+            if(mirror.write_to_address(0, data, DATA_SIZE) != STM24256::EEPROM_OK)
+            {
+                printf("bench_mirror: mirror write failed\n");
+                return 1;
+            }
+            mirror_ms[pass] = (sim::now_us - start_us) / 1000.0;
+        }
+
+        printf("%10d %12.1f %12.1f %12.1f %7.2fx\n", frequency, single_ms, mirror_ms[0], mirror_ms[1],
+               mirror_ms[1] / single_ms);
+    }
+
+    return 0;
+}
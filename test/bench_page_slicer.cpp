@@ -0,0 +1,138 @@
+/**
+  * @file    bench_page_slicer.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host benchmark of Page_Slicer against the byte-walking get_array_slice_locs it replaced
+  */
+
+/** Includes
+ */
+#include <chrono>
+#include "STM24256.h"
+
+#define ADDRESS_DIM 0
+#define LENGTH_DIM  1
+
+typedef int (*Array_16x2)[2];
+
+/** The page split of driver v1.x, which walks every byte of the range to find the page
+ *  boundaries and returns a table shared by every caller. Reproduced here for comparison only
+ */
+static Array_16x2 get_array_slice_locs(uint16_t start_address, int data_length, int &boundaries)
+{
+    static int chunks[16][2] = {0};
+
+    int current_page = -1;
+    int end_page = ((start_address + data_length) - 1) / 64;
+
+    uint16_t chunk_start_address = start_address;
+    int chunk_index = 0;
+
+    for(uint16_t address = start_address; address < start_address + data_length; address++)
+    {
+        int byte_page = address / 64;
+
+        if(current_page == -1)
+        {
+            current_page = byte_page;
+        }
+        else if(current_page != byte_page)
+        {
+            chunks[chunk_index][LENGTH_DIM] = address - chunk_start_address;
+            chunks[chunk_index][ADDRESS_DIM] = chunk_start_address;
+
+            current_page = byte_page;
+            chunk_start_address = address;
+            chunk_index++;
+            boundaries++;
+        }
+
+        if(current_page == end_page)
+        {
+            chunks[chunk_index][LENGTH_DIM] = (start_address + data_length) - chunk_start_address;
+            chunks[chunk_index][ADDRESS_DIM] = chunk_start_address;
+            break;
+        }
+    }
+
+    return chunks;
+}
+
+/** Slices are produced at compile time for constant operations
+ */
+static constexpr int constant_slices = STM24256::Page_Slicer(60, 1000).count();
+static_assert(constant_slices == 17, "Page_Slicer must be evaluable at compile time");
+
+/** Consumes results so that the compiler cannot discard the work being timed
+ */
+static volatile long sink;
+
+static const int ROUNDS = 2000;
+
+template<typename F>
+static double time_ns(F function)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+int main()
+{
+    printf("bench_page_slicer: time to split one operation into pages\n");
+    printf("%8s %16s %16s %8s\n", "length", "byte walk (ns)", "Page_Slicer (ns)", "speedup");
+
+    const int lengths[] = {16, 64, 256, 1024};
+
+    for(int length : lengths)
+    {
+        /** The two must agree before their speed is of interest
+         */
+        for(int start = 0; start < 64; start++)
+        {
+            int boundaries = 0;
+            Array_16x2 chunks = get_array_slice_locs(start, length, boundaries);
+
+            STM24256::Page_Slicer slicer(start, length);
+            STM24256::Page_Slice slice;
+            for(int chunk = 0; chunk <= boundaries; chunk++)
+            {
+                if(!slicer.next(slice) || (int)slice.address != chunks[chunk][ADDRESS_DIM] ||
+                   slice.length != chunks[chunk][LENGTH_DIM])
+                {
+                    printf("bench_page_slicer: slices differ at start %d, length %d\n", start, length);
+                    return 1;
+                }
+            }
+        }
+
+        double walk_ns = time_ns([length]
+        {
+            for(int round = 0; round < ROUNDS; round++)
+            {
+                int boundaries = 0;
+                Array_16x2 chunks = get_array_slice_locs(round % 64, length, boundaries);
+                sink = sink + chunks[boundaries][LENGTH_DIM];
+            }
+        });
+
+        double slicer_ns = time_ns([length]
+        {
+            for(int round = 0; round < ROUNDS; round++)
+            {
+                STM24256::Page_Slicer slicer(round % 64, length);
+                STM24256::Page_Slice slice;
+                while(slicer.next(slice))
+                {
+                    sink = sink + slice.length;
+                }
+            }
+        });
+
+        printf("%8d %16.1f %16.1f %7.1fx\n", length, walk_ns / ROUNDS, slicer_ns / ROUNDS, walk_ns / slicer_ns);
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+  * @file    bench_scan_crc.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host benchmark of a whole-chip scan_crc against bus frequency
+  */
+
+/** Includes
+ */
+#include "STM24256.h"
+#include "STM24256_CRC.h"
+
+/** Size of the caller buffer used when reading the region back for comparison
+ */
+static const int CHUNK_SIZE = 1024;
+
+int main()
+{
+    const int size = STM24256::EEPROM_MEM_ARRAY_SIZE;
+
+    sim::Chip chip;
+    for(int i = 0; i < size; i++)
+    {
+        chip.mem[i] = (uint8_t)(i * 31 + 7);
+    }
+    sim::chips.push_back(&chip);
+
+    uint32_t expected = STM24256_CRC::crc32(0, (const char *)&chip.mem[0], size);
+
+    printf("bench_scan_crc: CRC-32 of all %d bytes; bus time only, the CRC itself is not timed\n", size);
+    printf("%10s %12s %12s %8s %14s %8s\n", "bus Hz", "floor ms", "scan_crc ms", "starts", "1 KB reads ms", "starts");
+
+    const int frequencies[] = {100000, 400000, 1000000};
+
+    for(int frequency : frequencies)
+    {
+        STM24256 eeprom(PA_0, PB_7, PB_6, frequency);
+
+        /** Time to clock every byte of the region at this frequency, with nothing else
+         */
+        double floor_ms = (double)size * 9 * 1000 / frequency;
+
+        sim::starts = 0;
+        uint64_t start_us = sim::now_us;
+        uint32_t crc = 0;
+        if(eeprom.scan_crc(0, size, crc) != STM24256::EEPROM_OK || crc != expected)
+        {
+            printf("bench_scan_crc: scan_crc failed at %d Hz\n", frequency);
+            return 1;
+        }
+        double scan_ms = (sim::now_us - start_us) / 1000.0;
+        long scan_starts = sim::starts;
+
+        /** The same region read into a caller buffer a chunk at a time, as a scan was done before
+         */
+        static char buffer[CHUNK_SIZE];
+        sim::starts = 0;
+        start_us = sim::now_us;
+        crc = 0;
+        for(int address = 0; address < size; address += CHUNK_SIZE)
+        {
+            if(eeprom.read_from_address(address, buffer, CHUNK_SIZE) != STM24256::EEPROM_OK)
+            {
+                printf("bench_scan_crc: read failed at %d Hz\n", frequency);
+                return 1;
+            }
+            crc = STM24256_CRC::crc32(crc, buffer, CHUNK_SIZE);
+        }
+        double chunked_ms = (sim::now_us - start_us) / 1000.0;
+
+        printf("%10d %12.1f %12.1f %8ld %14.1f %8ld\n", frequency, floor_ms, scan_ms, scan_starts,
+               chunked_ms, (long)sim::starts);
+    }
+
+    return 0;
+}
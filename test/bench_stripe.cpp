@@ -0,0 +1,99 @@
+/**
+  * @file    bench_stripe.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host benchmark of STM24xxx_Stripe throughput against the amount of I2C buses
+  */
+
+/** Includes
+ */
+#include "STM24256.h"
+#include "STM24256_Stripe.h"
+
+static const int MAX_BUSES = 3;
+
+/** Amount of data written and read back in each measurement
+ */
+static const int DATA_SIZE = 24576;
+
+/** Each bus has its own SDA, SCL and write control pins
+ */
+static const PinName SDA_PINS[MAX_BUSES] = {PB_7, PB_9, PB_11};
+static const PinName SCL_PINS[MAX_BUSES] = {PB_6, PB_8, PB_10};
+static const PinName WC_PINS[MAX_BUSES]  = {PA_0, PA_1, PA_2};
+
+int main()
+{
+    static char data[DATA_SIZE];
+    static char readback[DATA_SIZE];
+    for(int i = 0; i < DATA_SIZE; i++)
+    {
+        data[i] = (char)(i * 13 + 1);
+    }
+
+    static sim::Chip chips[MAX_BUSES];
+
+    printf("bench_stripe: %d KB written and verified, then read, striped across EEPROMs on separate buses; tWR %d us\n",
+           DATA_SIZE / 1024, chips[0].twr_us);
+    printf("%10s %6s %10s %8s %10s %8s\n", "bus Hz", "buses", "write ms", "speedup", "read ms", "speedup");
+
+    const int frequencies[] = {400000, 1000000};
+
+    for(int frequency : frequencies)
+    {
+        double single_write_ms = 0;
+        double single_read_ms = 0;
+
+        for(int bus_count = 1; bus_count <= MAX_BUSES; bus_count++)
+        {
+            sim::reset();
+            STM24256 *eeproms[MAX_BUSES];
+            for(int bus = 0; bus < bus_count; bus++)
+            {
+                chips[bus].sda = SDA_PINS[bus];
+                chips[bus].wc = WC_PINS[bus];
+                sim::chips.push_back(&chips[bus]);
+                eeproms[bus] = new STM24256(WC_PINS[bus], SDA_PINS[bus], SCL_PINS[bus], frequency);
+            }
+
+            STM24256_Stripe *stripe = new STM24256_Stripe(eeproms, bus_count);
+
+            /** Each thread keeps its own simulated clock, and the stripe's semaphores carry the
+             *  latest of them back to this thread once every bus has finished
+             */
+            uint64_t start_us = sim::now_us;
+            if(stripe->write_to_address(0, data, DATA_SIZE) != STM24256::EEPROM_OK)
+            {
+                printf("bench_stripe: write failed with %d buses\n", bus_count);
+                return 1;
+            }
+            double write_ms = (sim::now_us - start_us) / 1000.0;
+
+            start_us = sim::now_us;
+            if(stripe->read_from_address(0, readback, DATA_SIZE) != STM24256::EEPROM_OK ||
+               memcmp(readback, data, DATA_SIZE) != 0)
+            {
+                printf("bench_stripe: read back failed with %d buses\n", bus_count);
+                return 1;
+            }
+            double read_ms = (sim::now_us - start_us) / 1000.0;
+
+            if(bus_count == 1)
+            {
+                single_write_ms = write_ms;
+                single_read_ms = read_ms;
+            }
+
+            printf("%10d %6d %10.1f %7.2fx %10.1f %7.2fx\n", frequency, bus_count, write_ms,
+                   single_write_ms / write_ms, read_ms, single_read_ms / read_ms);
+
+            delete stripe;
+            for(int bus = 0; bus < bus_count; bus++)
+            {
+                delete eeproms[bus];
+            }
+        }
+    }
+
+    return 0;
+}
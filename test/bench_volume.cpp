@@ -0,0 +1,89 @@
+/**
+  * @file    bench_volume.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host benchmark of STM24xxx_Volume write throughput against the amount of EEPROMs on one bus
+  */
+
+/** Includes
+ */
+#include "STM24256.h"
+#include "STM24256_Volume.h"
+
+static const int MAX_CHIPS = 8;
+
+/** Amount of data written and read back in each measurement
+ */
+static const int DATA_SIZE = 16384;
+
+int main()
+{
+    static char data[DATA_SIZE];
+    static char readback[DATA_SIZE];
+    for(int i = 0; i < DATA_SIZE; i++)
+    {
+        data[i] = (char)(i * 7 + 3);
+    }
+
+    static sim::Chip chips[MAX_CHIPS];
+
+    printf("bench_volume: %d KB written unverified, then read, on one bus; tWR %d us\n",
+           DATA_SIZE / 1024, chips[0].twr_us);
+    printf("%10s %6s %10s %12s %8s %10s\n", "bus Hz", "chips", "write ms", "write KB/s", "speedup", "read ms");
+
+    const int frequencies[] = {400000, 1000000};
+    const int chip_counts[] = {1, 2, 4, 8};
+
+    for(int frequency : frequencies)
+    {
+        double single_ms = 0;
+
+        for(int chip_count : chip_counts)
+        {
+            /** EEPROMs are told apart by their E0-E2 pins, all sharing the bus and write control
+             */
+            sim::reset();
+            STM24256 *eeproms[MAX_CHIPS];
+            for(int chip = 0; chip < chip_count; chip++)
+            {
+                chips[chip].devsel = 0xA0 | (chip << 1);
+                sim::chips.push_back(&chips[chip]);
+                eeproms[chip] = new STM24256(PA_0, PB_7, PB_6, frequency, chip);
+            }
+
+            STM24256_Volume volume(eeproms, chip_count, false);
+
+            uint64_t start_us = sim::now_us;
+            if(volume.write_to_address(0, data, DATA_SIZE) != STM24256::EEPROM_OK)
+            {
+                printf("bench_volume: write failed with %d chips\n", chip_count);
+                return 1;
+            }
+            double write_ms = (sim::now_us - start_us) / 1000.0;
+
+            start_us = sim::now_us;
+            if(volume.read_from_address(0, readback, DATA_SIZE) != STM24256::EEPROM_OK ||
+               memcmp(readback, data, DATA_SIZE) != 0)
+            {
+                printf("bench_volume: read back failed with %d chips\n", chip_count);
+                return 1;
+            }
+            double read_ms = (sim::now_us - start_us) / 1000.0;
+
+            if(chip_count == 1)
+            {
+                single_ms = write_ms;
+            }
+
+            printf("%10d %6d %10.1f %12.1f %7.2fx %10.1f\n", frequency, chip_count, write_ms,
+                   DATA_SIZE / 1024.0 / (write_ms / 1000.0), single_ms / write_ms, read_ms);
+
+            for(int chip = 0; chip < chip_count; chip++)
+            {
+                delete eeproms[chip];
+            }
+        }
+    }
+
+    return 0;
+}
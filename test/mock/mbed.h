@@ -0,0 +1,440 @@
+/**
+  * @file    mbed.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host mock of the subset of Mbed OS used by the STM24256 EEPROM driver module,
+  *          backed by a simulated I2C bus, EEPROMs and clock
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes
+ */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+typedef int PinName;
+
+enum
+{
+    PA_0 = 0, PA_1, PA_2, PA_3,
+    PB_6, PB_7, PB_8, PB_9, PB_10, PB_11,
+    PIN_COUNT,
+    NC = -1
+};
+
+/** Simulated hardware. Each thread has a clock of its own, which the mock synchronisation
+ *  primitives carry from one thread to another, so that work done concurrently on different
+ *  buses overlaps in simulated time while work serialised by a lock does not
+ */
+namespace sim
+{
+    /** A simulated M24xxx EEPROM
+     */
+    struct Chip
+    {
+        /** SDA pin of the bus the EEPROM sits on, or NC to respond on any bus
+         */
+        PinName sda = NC;
+
+        /** Write control pin of the EEPROM
+         */
+        PinName wc = PA_0;
+
+        /** Device select code for a write, with the E pins but no bank bits
+         */
+        uint8_t devsel = 0xA0;
+
+        int page = 64;
+        int cap = 32768;
+        int bank_bits = 0;
+
+        /** Each write cycle lasts twr_us plus a pseudo-random amount of up to twr_jitter_us
+         */
+        int twr_us = 3000;
+        int twr_jitter_us = 0;
+
+        /** Complete write cycles without storing the data, as a failing EEPROM would
+         */
+        bool drop_writes = false;
+
+        std::vector<uint8_t> mem;
+        uint32_t counter = 0;
+        uint64_t busy_until = 0;
+        uint32_t seed = 1;
+
+        Chip(int page_size = 64, int capacity = 32768, uint8_t fill = 0xFF) :
+             page(page_size), cap(capacity), mem(capacity, fill) {}
+    };
+
+    /** Simulated time of the calling thread in microseconds
+     */
+    extern thread_local uint64_t now_us;
+
+    /** EEPROMs attached to the simulated buses
+     */
+    extern std::vector<Chip *> chips;
+
+    /** Totals of start conditions, bytes clocked and completed transactions on all buses
+     */
+    extern std::atomic<long> starts;
+    extern std::atomic<long> bytes;
+    extern std::atomic<long> transactions;
+
+    /** Complete I2C::transfer on a thread of its own, storing the data and invoking the callback
+     *  some time after transfer has returned, as the interrupt of a real asynchronous transfer
+     *  would. The next lock or unlock of the bus waits for the transfer and takes up its time
+     */
+    extern bool defer_transfers;
+
+    /** Totals of transfers completed on a thread of their own, and of unlocks of the bus made
+     *  before the callback of such a transfer, which on hardware would cut the transfer short
+     */
+    extern std::atomic<long> deferred_transfers;
+    extern std::atomic<long> early_unlocks;
+
+    /** Level of each pin driven by a DigitalOut
+     */
+    extern int pin_level[PIN_COUNT];
+
+    /** Bring the calling thread's clock forward to at least time_us
+     */
+    inline void sync(uint64_t time_us)
+    {
+        if(now_us < time_us)
+        {
+            now_us = time_us;
+        }
+    }
+
+    /** An interval during which a bus was held, from its outermost lock to the matching unlock
+     */
+    struct Hold
+    {
+        uint64_t start_us;
+        uint64_t end_us;
+    };
+
+    /** Intervals during which the bus with SDA pin sda has been held since the last reset
+     */
+    std::vector<Hold> bus_holds(PinName sda);
+
+    /** Remove all EEPROMs and reset the totals and recorded bus holds. The clock is left running
+     */
+    void reset();
+}
+
+inline void wait_us(int us)
+{
+    sim::now_us += us;
+}
+
+class DigitalOut
+{
+    public:
+        DigitalOut(PinName pin, int value = 0) : _pin(pin) { sim::pin_level[_pin] = value; }
+        DigitalOut &operator=(int value) { sim::pin_level[_pin] = value; return *this; }
+        operator int() { return sim::pin_level[_pin]; }
+
+    private:
+        PinName _pin;
+};
+
+/** Recursive mutex whose release time is carried over to the next thread to acquire it
+ */
+class PlatformMutex
+{
+    public:
+        void lock() { _mutex.lock(); sim::sync(_released_us); }
+        void unlock() { _released_us = sim::now_us; _mutex.unlock(); }
+
+    private:
+        std::recursive_mutex _mutex;
+        uint64_t _released_us = 0;
+};
+
+namespace mbed
+{
+    template<typename F> class Callback;
+
+    template<typename R, typename... A>
+    class Callback<R(A...)>
+    {
+        public:
+            Callback() {}
+            Callback(R (*function)(A...)) : _function(function) {}
+            template<typename T> Callback(T *object, R (T::*method)(A...)) :
+                _function([object, method](A... args) { return (object->*method)(args...); }) {}
+            template<typename L, typename = typename std::enable_if<!std::is_integral<L>::value>::type>
+            Callback(L lambda) : _function(lambda) {}
+            R operator()(A... args) const { return _function(args...); }
+            R call(A... args) const { return _function(args...); }
+            explicit operator bool() const { return (bool)_function; }
+
+        private:
+            std::function<R(A...)> _function;
+    };
+
+    template<typename T, typename R, typename... A>
+    Callback<R(A...)> callback(T *object, R (T::*method)(A...)) { return Callback<R(A...)>(object, method); }
+
+    template<typename R, typename... A>
+    Callback<R(A...)> callback(R (*function)(A...)) { return Callback<R(A...)>(function); }
+
+    template<typename T, typename R>
+    Callback<R()> callback(R (*function)(T *), T *argument) { return Callback<R()>([function, argument] { return function(argument); }); }
+
+    typedef Callback<void(int)> event_callback_t;
+
+    class Timer
+    {
+        public:
+            void start() { if(!_running) { _started_us = sim::now_us; _running = true; } }
+            void stop() { if(_running) { _elapsed_us += sim::now_us - _started_us; _running = false; } }
+            void reset() { _elapsed_us = 0; _started_us = sim::now_us; }
+            int read_us() { return (int)(_elapsed_us + (_running ? sim::now_us - _started_us : 0)); }
+            int read_ms() { return read_us() / 1000; }
+
+        private:
+            uint64_t _started_us = 0;
+            uint64_t _elapsed_us = 0;
+            bool _running = false;
+    };
+
+    /** I2C master on a simulated bus, identified by its SDA pin. Each byte takes nine clock
+     *  periods of the bus frequency, and the bus lock serialises its users in simulated time
+     */
+    class I2C
+    {
+        public:
+            enum Acknowledge { NoACK = 0, ACK = 1 };
+
+            I2C(PinName sda, PinName scl) : _sda(sda) { (void)scl; }
+            ~I2C() { finish_transfer(); }
+            void frequency(int hz) { _hz = hz; }
+            int start();
+            int stop();
+            int write(int data);
+            int read(int ack);
+            int write(int address, const char *data, int length, bool repeated = false);
+            int read(int address, char *data, int length, bool repeated = false);
+            int transfer(int address, const char *tx, int tx_length, char *rx, int rx_length,
+                         const event_callback_t &callback, int event = 0, bool repeated = false);
+            void abort_transfer() {}
+            void lock();
+            void unlock();
+
+        private:
+            sim::Chip *select(int address, uint32_t &bank);
+            void clock_bytes(int count);
+            void commit();
+            int run_transfer(int address, const char *tx, int tx_length, char *rx, int rx_length, bool repeated);
+            void finish_transfer();
+
+            PinName _sda;
+            int _hz = 100000;
+            sim::Chip *_chip = nullptr;
+            bool _reading = false;
+            bool _in_transaction = false;
+            bool _address_phase = false;
+            std::vector<uint8_t> _written;
+            uint32_t _bank = 0;
+            std::thread _transfer;
+            std::atomic<bool> _transfer_pending{false};
+            uint64_t _transfer_end_us = 0;
+    };
+}
+
+#define I2C_EVENT_ERROR             (1 << 1)
+#define I2C_EVENT_TRANSFER_COMPLETE (1 << 3)
+#define I2C_EVENT_ALL               0x1F
+#define DEVICE_I2C_ASYNCH 1
+
+namespace events
+{
+    /** Event queue dispatched on the calling thread in order of simulated time. The amount
+     *  of pending events may be limited to exercise a full queue
+     */
+    class EventQueue
+    {
+        public:
+            EventQueue(int size = 0) { (void)size; }
+
+            template<typename F> int call(F function) { return call_in(0, function); }
+            template<typename F> int call_in(int ms, F function) { return post(ms, 0, mbed::Callback<void()>(function)); }
+            template<typename F> int call_every(int ms, F function) { return post(ms, ms, mbed::Callback<void()>(function)); }
+
+            bool cancel(int id)
+            {
+                for(size_t i = 0; i < _events.size(); i++)
+                {
+                    if(_events[i].id == id)
+                    {
+                        _events.erase(_events.begin() + i);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /** Dispatch events in order of simulated time, advancing the clock to each as it falls
+             *  due, until only periodic events remain
+             */
+            void dispatch_all()
+            {
+                while(has_one_shot())
+                {
+                    size_t first = 0;
+                    for(size_t i = 1; i < _events.size(); i++)
+                    {
+                        if(_events[i].due_us < _events[first].due_us)
+                        {
+                            first = i;
+                        }
+                    }
+                    Event event = _events[first];
+                    _events.erase(_events.begin() + first);
+                    if(event.period_ms > 0)
+                    {
+                        _events.push_back({event.due_us + (uint64_t)event.period_ms * 1000, event.period_ms, event.function, event.id});
+                    }
+                    sim::sync(event.due_us);
+                    event.function();
+                }
+            }
+
+            size_t limit = (size_t)-1;
+
+        private:
+            struct Event
+            {
+                uint64_t due_us;
+                int period_ms;
+                mbed::Callback<void()> function;
+                int id;
+            };
+
+            int post(int delay_ms, int period_ms, mbed::Callback<void()> function)
+            {
+                if(_events.size() >= limit)
+                {
+                    return 0;
+                }
+                _events.push_back({sim::now_us + (uint64_t)delay_ms * 1000, period_ms, function, _next_id});
+                return _next_id++;
+            }
+
+            bool has_one_shot()
+            {
+                for(size_t i = 0; i < _events.size(); i++)
+                {
+                    if(_events[i].period_ms == 0)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            std::vector<Event> _events;
+            int _next_id = 1;
+    };
+}
+
+#define MBED_CONF_RTOS_PRESENT 1
+
+typedef enum
+{
+    osPriorityNormal = 24
+} osPriority;
+
+namespace rtos
+{
+    namespace ThisThread
+    {
+        inline void yield() { std::this_thread::yield(); }
+    }
+
+    /** Counting semaphore whose releases carry the releasing thread's clock to the thread
+     *  that acquires
+     */
+    class Semaphore
+    {
+        public:
+            Semaphore(int count = 0) : _count(count) {}
+            void acquire()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this] { return _count > 0; });
+                _count--;
+                sim::sync(_released_us);
+            }
+            int release()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _count++;
+                    if(_released_us < sim::now_us)
+                    {
+                        _released_us = sim::now_us;
+                    }
+                }
+                _condition.notify_one();
+                return 0;
+            }
+
+        private:
+            std::mutex _mutex;
+            std::condition_variable _condition;
+            int _count;
+            uint64_t _released_us = 0;
+    };
+
+    class Thread
+    {
+        public:
+            Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = 0)
+            {
+                (void)priority;
+                (void)stack_size;
+            }
+            ~Thread()
+            {
+                if(_thread.joinable())
+                {
+                    _thread.detach();
+                }
+            }
+            int start(mbed::Callback<void()> task)
+            {
+                _thread = std::thread([task] { task(); });
+                return 0;
+            }
+            int join()
+            {
+                if(_thread.joinable())
+                {
+                    _thread.join();
+                }
+                return 0;
+            }
+
+        private:
+            std::thread _thread;
+    };
+}
+
+using namespace mbed;
+using namespace events;
+using namespace rtos;
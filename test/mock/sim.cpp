@@ -0,0 +1,381 @@
+/**
+  * @file    sim.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Simulated I2C bus and M24xxx EEPROMs behind the host mock of Mbed OS
+  */
+
+/** Includes
+ */
+#include "mbed.h"
+
+namespace sim
+{
+    thread_local uint64_t now_us = 0;
+    std::vector<Chip *> chips;
+    std::atomic<long> starts(0);
+    std::atomic<long> bytes(0);
+    std::atomic<long> transactions(0);
+    bool defer_transfers = false;
+    std::atomic<long> deferred_transfers(0);
+    std::atomic<long> early_unlocks(0);
+    int pin_level[PIN_COUNT] = {0};
+
+    /** Each bus is held by one user at a time, and is free from the time its last user
+     *  released it
+     */
+    struct Bus
+    {
+        std::recursive_mutex mutex;
+        uint64_t released_us = 0;
+        int depth = 0;
+        uint64_t locked_us = 0;
+        std::vector<Hold> holds;
+    };
+
+    static Bus buses[PIN_COUNT];
+
+    std::vector<Hold> bus_holds(PinName sda)
+    {
+        std::lock_guard<std::recursive_mutex> lock(buses[sda].mutex);
+        return buses[sda].holds;
+    }
+
+    void reset()
+    {
+        chips.clear();
+        starts = 0;
+        bytes = 0;
+        transactions = 0;
+
+        for(Bus &bus : buses)
+        {
+            std::lock_guard<std::recursive_mutex> lock(bus.mutex);
+            bus.holds.clear();
+        }
+    }
+}
+
+using namespace sim;
+
+namespace mbed
+{
+
+void I2C::lock()
+{
+    finish_transfer();
+
+    Bus &bus = buses[_sda];
+
+    bus.mutex.lock();
+    sync(bus.released_us);
+
+    if(bus.depth++ == 0)
+    {
+        bus.locked_us = now_us;
+    }
+}
+
+void I2C::unlock()
+{
+    if(_transfer_pending)
+    {
+        early_unlocks++;
+    }
+
+    finish_transfer();
+
+    Bus &bus = buses[_sda];
+
+    if(--bus.depth == 0)
+    {
+        bus.holds.push_back({bus.locked_us, now_us});
+    }
+
+    bus.released_us = now_us;
+    bus.mutex.unlock();
+}
+
+void I2C::clock_bytes(int count)
+{
+    now_us += (uint64_t)count * 9 * 1000000 / _hz;
+    bytes += count;
+}
+
+/** Advance the address counter of an EEPROM past the byte just read. In parts divided into
+ *  banks the counter rolls over from the end of a bank to its start, rather than continuing
+ *  into the next bank
+ */
+static uint32_t next_address(Chip *chip)
+{
+    uint32_t size = chip->bank_bits > 0 ? (uint32_t)chip->cap >> chip->bank_bits : (uint32_t)chip->cap;
+    uint32_t base = chip->counter - chip->counter % size;
+
+    return base + (chip->counter + 1) % size;
+}
+
+/** Find the EEPROM on this bus that acknowledges a device select code. An EEPROM busy with
+ *  its internal write cycle does not acknowledge
+ */
+Chip *I2C::select(int address, uint32_t &bank)
+{
+    for(Chip *chip : chips)
+    {
+        if(chip->sda != NC && chip->sda != _sda)
+        {
+            continue;
+        }
+
+        int mask = 0xFE & ~(((1 << chip->bank_bits) - 1) << 1);
+        if((address & mask) == (chip->devsel & mask))
+        {
+            if(now_us < chip->busy_until)
+            {
+                return nullptr;
+            }
+
+            bank = (address >> 1) & ((1 << chip->bank_bits) - 1);
+            return chip;
+        }
+    }
+
+    return nullptr;
+}
+
+/** Conclude a write transaction. Two address bytes alone load the address counter, while
+ *  data following them is programmed into the addressed page if write control is low,
+ *  starting the internal write cycle
+ */
+void I2C::commit()
+{
+    if(_chip != nullptr && !_reading && _written.size() >= 2)
+    {
+        uint32_t address = ((_bank << 16) | (_written[0] << 8) | _written[1]) % _chip->cap;
+
+        if(_written.size() > 2 && pin_level[_chip->wc] == 0)
+        {
+            uint32_t base = address - address % _chip->page;
+            int length = (int)_written.size() - 2;
+
+            if(!_chip->drop_writes)
+            {
+                for(int i = 0; i < length; i++)
+                {
+                    _chip->mem[base + (address - base + i) % _chip->page] = _written[2 + i];
+                }
+            }
+
+            _chip->seed = _chip->seed * 1103515245 + 12345;
+            int jitter = _chip->twr_jitter_us > 0 ? (int)((_chip->seed >> 8) % (_chip->twr_jitter_us + 1)) : 0;
+
+            _chip->busy_until = now_us + _chip->twr_us + jitter;
+            _chip->counter = base + (address - base + length) % _chip->page;
+        }
+        else
+        {
+            _chip->counter = address;
+        }
+    }
+
+    _chip = nullptr;
+    _written.clear();
+    _in_transaction = false;
+}
+
+int I2C::start()
+{
+    if(_in_transaction)
+    {
+        commit();
+    }
+
+    starts++;
+    _in_transaction = true;
+    _address_phase = true;
+    _chip = nullptr;
+
+    return 0;
+}
+
+int I2C::stop()
+{
+    commit();
+    transactions++;
+
+    return 0;
+}
+
+int I2C::write(int data)
+{
+    clock_bytes(1);
+
+    if(_address_phase)
+    {
+        _address_phase = false;
+        _reading = data & 1;
+        _chip = select(data, _bank);
+        _written.clear();
+
+        return _chip != nullptr ? ACK : NoACK;
+    }
+
+    if(_chip == nullptr)
+    {
+        return NoACK;
+    }
+
+    _written.push_back((uint8_t)data);
+
+    return ACK;
+}
+
+int I2C::read(int ack)
+{
+    (void)ack;
+    clock_bytes(1);
+
+    if(_chip == nullptr)
+    {
+        return 0xFF;
+    }
+
+    uint8_t data = _chip->mem[_chip->counter];
+    _chip->counter = next_address(_chip);
+
+    return data;
+}
+
+int I2C::write(int address, const char *data, int length, bool repeated)
+{
+    start();
+
+    if(write(address) != ACK)
+    {
+        stop();
+        return 1;
+    }
+
+    for(int i = 0; i < length; i++)
+    {
+        write((uint8_t)data[i]);
+    }
+
+    if(!repeated)
+    {
+        stop();
+    }
+
+    return 0;
+}
+
+int I2C::read(int address, char *data, int length, bool repeated)
+{
+    /** A repeated start after a dummy write leaves the address counter where it was loaded
+     */
+    if(_in_transaction)
+    {
+        commit();
+    }
+
+    starts++;
+    clock_bytes(1);
+
+    /** A current address read continues from the counter, whatever bank the device select
+     *  code names, so a read that continues past the end of a bank wraps to its start
+     */
+    uint32_t bank = 0;
+    Chip *chip = select(address, bank);
+    if(chip == nullptr)
+    {
+        transactions++;
+        return 1;
+    }
+
+    for(int i = 0; i < length; i++)
+    {
+        data[i] = (char)chip->mem[chip->counter];
+        chip->counter = next_address(chip);
+    }
+
+    clock_bytes(length);
+
+    if(!repeated)
+    {
+        transactions++;
+    }
+
+    return 0;
+}
+
+/** Transfers complete immediately, so the callback is invoked before transfer returns, unless
+ *  transfers are deferred
+ */
+int I2C::transfer(int address, const char *tx, int tx_length, char *rx, int rx_length,
+                  const event_callback_t &callback, int event, bool repeated)
+{
+    (void)event;
+
+    finish_transfer();
+
+    if(defer_transfers)
+    {
+        /** The transfer thread starts from the caller's time, and leaves its own end time for
+         *  finish_transfer. It waits a little in real time first, so that a caller reading the
+         *  data before the callback sees the buffer as it was
+         */
+        uint64_t start_us = now_us;
+        event_callback_t done = callback;
+        deferred_transfers++;
+        _transfer_pending = true;
+
+        _transfer = std::thread([=]
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            now_us = start_us;
+            int events = run_transfer(address, tx, tx_length, rx, rx_length, repeated);
+            _transfer_end_us = now_us;
+            _transfer_pending = false;
+            done(events);
+        });
+
+        return 0;
+    }
+
+    callback(run_transfer(address, tx, tx_length, rx, rx_length, repeated));
+
+    return 0;
+}
+
+/** Carry out a transfer
+ *
+ * @return I2C event flags describing how the transfer ended
+ */
+int I2C::run_transfer(int address, const char *tx, int tx_length, char *rx, int rx_length, bool repeated)
+{
+    int result = 0;
+
+    if(tx_length > 0)
+    {
+        result = write(address & ~1, tx, tx_length, rx_length > 0);
+    }
+
+    if(result == 0 && rx_length > 0)
+    {
+        result = read(address | 1, rx, rx_length, repeated);
+    }
+
+    return result != 0 ? I2C_EVENT_ERROR : I2C_EVENT_TRANSFER_COMPLETE;
+}
+
+/** Wait for a deferred transfer to finish, bringing the clock forward to its end
+ */
+void I2C::finish_transfer()
+{
+    if(_transfer.joinable())
+    {
+        _transfer.join();
+        sync(_transfer_end_us);
+    }
+}
+
+}
@@ -0,0 +1,41 @@
+/**
+  * @file    test.h
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Minimal checks shared by the host tests of the STM24256 EEPROM driver module
+  */
+
+/** Define to prevent recursive inclusion
+ */
+#pragma once
+
+/** Includes
+ */
+#include <mbed.h>
+
+/** Amount of failed checks in the test being run
+ */
+static int test_failures = 0;
+
+/** Record a failed check, with its location, if condition does not hold
+ */
+#define TEST_CHECK(condition)                                                       \
+    do                                                                              \
+    {                                                                               \
+        if(!(condition))                                                            \
+        {                                                                           \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);    \
+            test_failures++;                                                        \
+        }                                                                           \
+    } while(0)
+
+/** Report the outcome of the test being run
+ *
+ * @param name Name of the test
+ * @return Exit code of the test, non-zero if any check failed
+ */
+static inline int test_result(const char *name)
+{
+    printf("%s: %s\n", name, test_failures == 0 ? "passed" : "FAILED");
+    return test_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/**
+  * @file    test_ack_poll.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of write cycle ACK polling against an EEPROM with a variable tWR
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+
+/** Time taken to clock one byte at 400 kHz, the granularity of a single ACK poll
+ */
+static const int BYTE_US = 9 * 1000000 / 400000;
+
+int main()
+{
+    sim::Chip chip;
+    chip.twr_us = 1500;
+    chip.twr_jitter_us = 2500;
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+
+    /** Each page waits only as long as its own write cycle, which is measured to within
+     *  one poll
+     */
+    char data[1024];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 7 + 1);
+    }
+
+    for(int page = 0; page < 8; page++)
+    {
+        TEST_CHECK(eeprom.write_to_address(page * 64, &data[page * 64], 64, false) == STM24256::EEPROM_OK);
+        TEST_CHECK(eeprom.wait_for_write_cycle() == STM24256::EEPROM_OK);
+
+        int cycle_us = eeprom.get_last_write_cycle_us();
+        TEST_CHECK(cycle_us >= chip.twr_us);
+        TEST_CHECK(cycle_us <= chip.twr_us + chip.twr_jitter_us + 2 * BYTE_US);
+    }
+
+    /** A 1 KB write takes the sum of its write cycles rather than a fixed 5 ms per page
+     */
+    uint64_t start_us = sim::now_us;
+    TEST_CHECK(eeprom.write_to_address(0, data, sizeof(data)) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.wait_for_write_cycle() == STM24256::EEPROM_OK);
+    uint64_t elapsed_us = sim::now_us - start_us;
+
+    int pages = sizeof(data) / STM24256::EEPROM_PAGE_SIZE;
+    TEST_CHECK(elapsed_us < (uint64_t)pages * (5000 + (STM24256::EEPROM_PAGE_SIZE + 3) * BYTE_US));
+    TEST_CHECK(elapsed_us > (uint64_t)pages * chip.twr_us);
+    TEST_CHECK(memcmp(&chip.mem[0], data, sizeof(data)) == 0);
+
+    /** An EEPROM that never finishes its write cycle is abandoned at the ceiling
+     */
+    chip.twr_us = 50000;
+    chip.twr_jitter_us = 0;
+    eeprom.set_write_cycle_timeout_us(10000);
+
+    start_us = sim::now_us;
+    TEST_CHECK(eeprom.write_to_address(0, data, 128, false) == STM24256::EEPROM_WRITE_CYCLE_TIMEOUT);
+    elapsed_us = sim::now_us - start_us;
+    TEST_CHECK(elapsed_us >= 10000);
+    TEST_CHECK(elapsed_us < 10000 + 66 * BYTE_US + 2 * BYTE_US);
+
+    return test_result("test_ack_poll");
+}
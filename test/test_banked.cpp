@@ -0,0 +1,114 @@
+/**
+  * @file    test_banked.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of parts whose memory array is divided into banks selected by the device
+  *          select code, across the 64 KB bank boundaries
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_CRC.h"
+
+static char data[4096];
+static char readback[4096];
+
+/** Write, read and checksum ranges straddling each bank boundary of a part, and check the
+ *  limits at the end of its memory array
+ */
+template<class EEPROM_Type>
+static void check_part(int bank_bits)
+{
+    const uint32_t size = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+    const uint32_t bank = EEPROM_Type::EEPROM_BANK_SIZE;
+
+    TEST_CHECK(bank == 65536);
+    TEST_CHECK(EEPROM_Type::EEPROM_BANK_COUNT == 1 << bank_bits);
+
+    sim::reset();
+    sim::Chip chip(EEPROM_Type::EEPROM_PAGE_SIZE, size);
+    chip.bank_bits = bank_bits;
+    sim::chips.push_back(&chip);
+
+    EEPROM_Type eeprom(PA_0, PB_7, PB_6, 1000000);
+
+    for(uint32_t boundary = bank; boundary < size; boundary += bank)
+    {
+        /** A write straddling the boundary lands every byte at its own address, in both banks
+         */
+        uint32_t address = boundary - 1000;
+        TEST_CHECK(eeprom.write_to_address(address, data, 2000) == EEPROM_Type::EEPROM_OK);
+        TEST_CHECK(memcmp(&chip.mem[address], data, 2000) == 0);
+
+        memset(readback, 0, sizeof(readback));
+        TEST_CHECK(eeprom.read_from_address(address, readback, 2000) == EEPROM_Type::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, data, 2000) == 0);
+
+        /** A read beginning exactly on the boundary, and one ending exactly on it
+         */
+        TEST_CHECK(eeprom.read_from_address(boundary, readback, 16) == EEPROM_Type::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, &data[1000], 16) == 0);
+        TEST_CHECK(eeprom.read_from_address(boundary - 16, readback, 16) == EEPROM_Type::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, &data[1000 - 16], 16) == 0);
+
+        uint32_t crc = 0;
+        TEST_CHECK(eeprom.scan_crc(address, 2000, crc) == EEPROM_Type::EEPROM_OK);
+        TEST_CHECK(crc == STM24256_CRC::crc32(0, data, 2000));
+
+        /** Verification reads the range back in its own slices, which also straddle the boundary
+         */
+        TEST_CHECK(eeprom.verify_at_address(address, data, 2000) == EEPROM_Type::EEPROM_OK);
+    }
+
+    /** Bank bits in the device select code must follow the address, not stay in the bank of a
+     *  previous operation
+     */
+    TEST_CHECK(eeprom.read_from_address(16, readback, 16) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[16], 16) == 0);
+
+    /** The whole array, every bank of it, is checksummed in one call
+     */
+    uint32_t crc = 0;
+    TEST_CHECK(eeprom.scan_crc(0, size, crc) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(crc == STM24256_CRC::crc32(0, (const char *)&chip.mem[0], size));
+
+    /** The last bytes of the array can be reached, and nothing beyond them
+     */
+    TEST_CHECK(eeprom.write_to_address(size - 4, data, 4) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(memcmp(&chip.mem[size - 4], data, 4) == 0);
+    TEST_CHECK(eeprom.read_from_address(size - 4, readback, 4) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, data, 4) == 0);
+
+    TEST_CHECK(eeprom.read_from_address(size - 4, readback, 6) == EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeprom.write_to_address(size - 4, data, 6) == EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeprom.read_from_address(size, readback, 2) == EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeprom.write_to_address(0xFFFFFFFE, data, 2) == EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeprom.scan_crc(size - 4, 6, crc) == EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeprom.program_page(size, data, 2) == EEPROM_Type::EEPROM_DATA_LENGTH_TOO_LONG);
+
+    /** Empty and negative lengths are refused alike by every operation
+     */
+    for(int length : {0, -1})
+    {
+        TEST_CHECK(eeprom.read_from_address(0, readback, length) == EEPROM_Type::EEPROM_DATA_LENGTH_ZERO);
+        TEST_CHECK(eeprom.write_to_address(0, data, length) == EEPROM_Type::EEPROM_DATA_LENGTH_ZERO);
+        TEST_CHECK(eeprom.verify_at_address(0, data, length) == EEPROM_Type::EEPROM_DATA_LENGTH_ZERO);
+        TEST_CHECK(eeprom.scan_crc(0, length, crc) == EEPROM_Type::EEPROM_DATA_LENGTH_ZERO);
+        TEST_CHECK(eeprom.program_page(0, data, length) == EEPROM_Type::EEPROM_DATA_LENGTH_ZERO);
+    }
+}
+
+int main()
+{
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 7 + (i >> 8) + 1);
+    }
+
+    check_part<STM24M01>(1);
+    check_part<STM24M02>(2);
+
+    return test_result("test_banked");
+}
@@ -0,0 +1,117 @@
+/**
+  * @file    test_bus_hold.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of the bus hold statistics and of reads split by the bus hold quantum
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+
+/** Each byte takes nine clock periods, 9 us at 1 MHz
+ */
+static const int BYTE_US = 9;
+
+static char readback[2048];
+
+int main()
+{
+    sim::Chip chip;
+    for(int i = 0; i < (int)chip.mem.size(); i++)
+    {
+        chip.mem[i] = (uint8_t)(i * 5 + (i >> 8) + 3);
+    }
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 1000000);
+
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(50) == 0);
+    TEST_CHECK(eeprom.get_bus_hold_max_us() == 0);
+
+    /** Nine short addressed reads, each holding the bus for 20 bytes, and one long read of
+     *  1004 bytes. Percentiles are the upper bound of their histogram bucket, but never more
+     *  than the longest hold
+     */
+    for(int i = 0; i < 9; i++)
+    {
+        TEST_CHECK(eeprom.read_from_address(1000 * i, readback, 16) == STM24256::EEPROM_OK);
+    }
+    TEST_CHECK(eeprom.read_from_address(20000, readback, 1000) == STM24256::EEPROM_OK);
+
+    const int short_us = 20 * BYTE_US;
+    const int long_us = 1004 * BYTE_US;
+
+    TEST_CHECK(eeprom.get_bus_hold_max_us() == long_us);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(1) == 256 && short_us < 256);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(50) == 256);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(90) == 256);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(91) == long_us);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(100) == long_us);
+
+    /** Percentiles out of range are taken as the nearest valid one
+     */
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(0) == 256);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(-50) == 256);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(101) == long_us);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(1000000000) == long_us);
+
+    eeprom.reset_bus_hold_stats();
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(100) == 0);
+    TEST_CHECK(eeprom.get_bus_hold_max_us() == 0);
+
+    /** A quantum splits a long read into transactions of at most that many bytes, releasing the
+     *  bus between them; only the first is addressed, the rest continue from the address counter
+     */
+    const int quantum = 64;
+    eeprom.set_bus_hold_quantum(quantum);
+
+    sim::reset();
+    sim::chips.push_back(&chip);
+
+    TEST_CHECK(eeprom.read_from_address(333, readback, 1000) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[333], 1000) == 0);
+
+    std::vector<sim::Hold> holds = sim::bus_holds(PB_7);
+    TEST_CHECK(holds.size() == (1000 + quantum - 1) / quantum);
+    for(size_t i = 0; i < holds.size(); i++)
+    {
+        TEST_CHECK(holds[i].end_us - holds[i].start_us <= (uint64_t)(quantum + 4) * BYTE_US);
+    }
+
+    /** Every hold now falls in the same bucket, so the median is capped at the longest hold
+     */
+    TEST_CHECK(eeprom.get_bus_hold_max_us() == (quantum + 4) * BYTE_US);
+    TEST_CHECK(eeprom.get_bus_hold_percentile_us(50) == (quantum + 4) * BYTE_US);
+    TEST_CHECK(sim::bytes == 1000 + 4 + (long)(holds.size() - 1));
+
+    /** In paged mode each page is addressed afresh, and pages longer than the quantum are split
+     *  in the same way; a read of 200 bytes from 333 covers slices of 51, 64, 64 and 21 bytes
+     */
+    const int paged_quantum = 16;
+    eeprom.set_bus_hold_quantum(paged_quantum);
+    eeprom.set_read_mode(STM24256::EEPROM_READ_PAGED);
+
+    sim::reset();
+    sim::chips.push_back(&chip);
+
+    uint64_t start_us = sim::now_us;
+    TEST_CHECK(eeprom.read_from_address(333, readback, 200) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[333], 200) == 0);
+
+    /** Pages follow one another without waiting, as a read starts no write cycle
+     */
+    TEST_CHECK(sim::now_us - start_us < 300 * BYTE_US);
+
+    holds = sim::bus_holds(PB_7);
+    TEST_CHECK(holds.size() == 4 + 4 + 4 + 2);
+    for(size_t i = 0; i < holds.size(); i++)
+    {
+        TEST_CHECK(holds[i].end_us - holds[i].start_us <= (uint64_t)(paged_quantum + 4) * BYTE_US);
+    }
+
+    eeprom.set_read_mode(STM24256::EEPROM_READ_SEQUENTIAL);
+
+    return test_result("test_bus_hold");
+}
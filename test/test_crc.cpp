@@ -0,0 +1,110 @@
+/**
+  * @file    test_crc.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24256_CRC against known vectors, and of writes verified by CRC-32
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_CRC.h"
+
+static const int PAGE_SIZE = STM24256::EEPROM_PAGE_SIZE;
+
+/** Bit at a time CRC-32, reflected polynomial 0xEDB88320, continued in the same way as crc32
+ */
+static uint32_t crc32_bitwise(uint32_t crc, const char *data, int data_length)
+{
+    crc = ~crc;
+    for(int i = 0; i < data_length; i++)
+    {
+        crc ^= (uint8_t)data[i];
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+static int hook_calls = 0;
+
+static uint32_t counting_hook(uint32_t crc, const char *data, int data_length)
+{
+    hook_calls++;
+    return STM24256_CRC::crc32_software(crc, data, data_length);
+}
+
+int main()
+{
+    /** The standard check value, whole and continued across calls split at every point
+     */
+    const char check[] = "123456789";
+    TEST_CHECK(STM24256_CRC::crc32(0, check, 9) == 0xCBF43926);
+    TEST_CHECK(STM24256_CRC::crc32(0, check, 0) == 0);
+    TEST_CHECK(STM24256_CRC::crc32(STM24256_CRC::crc32(0, check, 4), &check[4], 5) == 0xCBF43926);
+
+    for(int split = 0; split <= 9; split++)
+    {
+        uint32_t crc = STM24256_CRC::crc32(0, check, split);
+        TEST_CHECK(STM24256_CRC::crc32(crc, &check[split], 9 - split) == 0xCBF43926);
+    }
+
+    /** The slicing-by-8 kernel agrees with a bit at a time CRC for every length and alignment
+     *  around its 8 byte steps
+     */
+    char data[96];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 37 + 11);
+    }
+
+    for(int offset = 0; offset < 8; offset++)
+    {
+        for(int length = 0; length <= (int)sizeof(data) - offset; length++)
+        {
+            TEST_CHECK(STM24256_CRC::crc32(0, &data[offset], length) == crc32_bitwise(0, &data[offset], length));
+        }
+    }
+
+    /** A hardware hook is used in place of the software kernel until it is removed
+     */
+    STM24256_CRC::set_hardware_hook(counting_hook);
+    TEST_CHECK(STM24256_CRC::crc32(0, check, 9) == 0xCBF43926 && hook_calls == 1);
+    STM24256_CRC::set_hardware_hook(NULL);
+    TEST_CHECK(STM24256_CRC::crc32(0, check, 9) == 0xCBF43926 && hook_calls == 1);
+
+    /** A synchronous write verified by CRC-32 succeeds when the data sticks, across pages and
+     *  from an unaligned address
+     */
+    sim::Chip chip;
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+    eeprom.set_verify_mode(STM24256::EEPROM_VERIFY_CRC);
+
+    char page_data[3 * PAGE_SIZE];
+    for(int i = 0; i < (int)sizeof(page_data); i++)
+    {
+        page_data[i] = (char)(i * 19 + 7);
+    }
+
+    TEST_CHECK(eeprom.write_to_address(PAGE_SIZE - 10, page_data, sizeof(page_data)) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&chip.mem[PAGE_SIZE - 10], page_data, sizeof(page_data)) == 0);
+
+    /** It fails when the data does not stick, and only when asked to verify
+     */
+    page_data[PAGE_SIZE] ^= 0x55;
+    chip.drop_writes = true;
+    TEST_CHECK(eeprom.write_to_address(PAGE_SIZE - 10, page_data, sizeof(page_data)) == STM24256::EEPROM_VERIFY_FAIL);
+    TEST_CHECK(eeprom.write_to_address(PAGE_SIZE - 10, page_data, sizeof(page_data), false) == STM24256::EEPROM_OK);
+    chip.drop_writes = false;
+
+    TEST_CHECK(eeprom.write_to_address(PAGE_SIZE - 10, page_data, sizeof(page_data)) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&chip.mem[PAGE_SIZE - 10], page_data, sizeof(page_data)) == 0);
+
+    return test_result("test_crc");
+}
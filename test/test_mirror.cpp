@@ -0,0 +1,288 @@
+/**
+  * @file    test_mirror.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24xxx_Mirror
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_Mirror.h"
+#include "STM24256_CRC.h"
+
+static const int PAGE_SIZE = STM24256::EEPROM_PAGE_SIZE;
+static const int PAGE_DATA_SIZE = STM24256_Mirror::EEPROM_MIRROR_PAGE_DATA_SIZE;
+
+/** Keep one EEPROM busy with a write cycle, by programming a page of it with what it holds
+ */
+static void start_write_cycle(STM24256 &eeprom, sim::Chip &chip, int page)
+{
+    TEST_CHECK(eeprom.program_page(page * PAGE_SIZE, (const char *)&chip.mem[page * PAGE_SIZE], PAGE_SIZE) == STM24256::EEPROM_OK);
+}
+
+/** Place a copy of a mirror page directly in an EEPROM, filled with value and stamped with
+ *  sequence and a valid CRC
+ */
+static void place_copy(sim::Chip &chip, int page, char value, uint16_t sequence)
+{
+    char copy[PAGE_SIZE];
+    memset(copy, value, PAGE_DATA_SIZE);
+    copy[PAGE_DATA_SIZE] = (char)sequence;
+    copy[PAGE_DATA_SIZE + 1] = (char)(sequence >> 8);
+
+    uint32_t crc = STM24256_CRC::crc32(0, copy, PAGE_DATA_SIZE + 2);
+    for(int i = 0; i < 4; i++)
+    {
+        copy[PAGE_DATA_SIZE + 2 + i] = (char)(crc >> (8 * i));
+    }
+
+    memcpy(&chip.mem[page * PAGE_SIZE], copy, PAGE_SIZE);
+}
+
+/** Read the same address from the mirror several times, so that both EEPROMs serve it, and
+ *  check that each read returns expected
+ */
+static void check_reads(STM24256_Mirror &mirror, uint32_t address, const char *expected, int length)
+{
+    char readback[PAGE_SIZE];
+
+    for(int read = 0; read < 4; read++)
+    {
+        TEST_CHECK(mirror.read_from_address(address, readback, length) == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, expected, length) == 0);
+    }
+}
+
+/** Determine whether or not both EEPROMs hold the same copy of a page
+ */
+static bool copies_match(sim::Chip *chips, int page)
+{
+    return memcmp(&chips[0].mem[page * PAGE_SIZE], &chips[1].mem[page * PAGE_SIZE], PAGE_SIZE) == 0;
+}
+
+int main()
+{
+    /** Two EEPROMs on one bus, told apart by their E0 pin
+     */
+    sim::Chip chips[2];
+    chips[0].twr_us = 5000;
+    chips[1].twr_us = 5000;
+    chips[1].devsel = 0xA2;
+    sim::chips.push_back(&chips[0]);
+    sim::chips.push_back(&chips[1]);
+
+    STM24256 primary(PA_0, PB_7, PB_6, 400000, 0);
+    STM24256 secondary(PA_0, PB_7, PB_6, 400000, 1);
+
+    STM24256_Mirror mirror(primary, secondary);
+
+    char data[256];
+    char readback[256];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 11 + 3);
+    }
+
+    TEST_CHECK(mirror.write_to_address(0, data, 100) == STM24256::EEPROM_OK);
+    TEST_CHECK(mirror.read_from_address(0, readback, 100) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, data, 100) == 0);
+
+    /** A read is served by the idle EEPROM without waiting for the write cycle of the other,
+     *  both for a page known to be consistent and for one a new mirror knows nothing about
+     */
+    uint64_t start_us = sim::now_us;
+    TEST_CHECK(mirror.read_from_address(20, readback, 4) == STM24256::EEPROM_OK);
+    uint64_t idle_us = sim::now_us - start_us;
+
+    for(int fresh = 0; fresh < 2; fresh++)
+    {
+        STM24256_Mirror other_mirror(primary, secondary);
+        STM24256_Mirror &reader = fresh ? other_mirror : mirror;
+
+        for(int busy = 0; busy < 2; busy++)
+        {
+            STM24256 &busy_eeprom = busy ? secondary : primary;
+            start_write_cycle(busy_eeprom, chips[busy], 500);
+
+            start_us = sim::now_us;
+            TEST_CHECK(reader.read_from_address(20, readback, 4) == STM24256::EEPROM_OK);
+            TEST_CHECK(sim::now_us - start_us < idle_us + 100);
+            TEST_CHECK(memcmp(readback, &data[20], 4) == 0);
+
+            TEST_CHECK(busy_eeprom.wait_for_write_cycle() == STM24256::EEPROM_OK);
+        }
+    }
+
+    /** Reads of a page whose copies agree touch only one EEPROM, in a single transaction as the
+     *  address counter of that EEPROM already points at the page
+     */
+    long transactions = sim::transactions;
+    TEST_CHECK(mirror.read_from_address(0, readback, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(sim::transactions - transactions == 1);
+
+    /** A partial write to a page whose copies are both damaged, as on EEPROMs holding foreign
+     *  data, is refused and leaves them untouched
+     */
+    for(int chip = 0; chip < 2; chip++)
+    {
+        memset(&chips[chip].mem[10 * PAGE_SIZE], 0x5A, 2 * PAGE_SIZE);
+    }
+
+    uint32_t lost = 10 * PAGE_DATA_SIZE;
+    TEST_CHECK(mirror.write_to_address(lost + 4, data, 8) == STM24256::EEPROM_VERIFY_FAIL);
+    TEST_CHECK(mirror.read_from_address(lost, readback, 4) == STM24256::EEPROM_VERIFY_FAIL);
+    for(int chip = 0; chip < 2; chip++)
+    {
+        for(int i = 0; i < PAGE_SIZE; i++)
+        {
+            TEST_CHECK(chips[chip].mem[10 * PAGE_SIZE + i] == 0x5A);
+        }
+    }
+
+    /** The page can be reinitialised explicitly, after which it reads as erased and takes
+     *  partial writes
+     */
+    TEST_CHECK(mirror.erase_page(lost + PAGE_DATA_SIZE - 1) == STM24256::EEPROM_OK);
+    TEST_CHECK(mirror.read_from_address(lost, readback, PAGE_DATA_SIZE) == STM24256::EEPROM_OK);
+    for(int i = 0; i < PAGE_DATA_SIZE; i++)
+    {
+        TEST_CHECK(readback[i] == (char)0xFF);
+    }
+
+    TEST_CHECK(mirror.write_to_address(lost + 4, data, 8) == STM24256::EEPROM_OK);
+    TEST_CHECK(mirror.read_from_address(lost, readback, 16) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&readback[4], data, 8) == 0);
+    TEST_CHECK(readback[3] == (char)0xFF && readback[12] == (char)0xFF);
+
+    /** A write covering the whole of a damaged page needs nothing from it
+     */
+    uint32_t whole = 11 * PAGE_DATA_SIZE;
+    TEST_CHECK(mirror.write_to_address(whole, data, PAGE_DATA_SIZE) == STM24256::EEPROM_OK);
+    TEST_CHECK(mirror.read_from_address(whole, readback, PAGE_DATA_SIZE) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, data, PAGE_DATA_SIZE) == 0);
+
+    TEST_CHECK(mirror.erase_page(mirror.get_size()) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+
+    STM24256_Mirror::EEPROM_Mirror_Stats_t stats;
+
+    /** A write dropped by one EEPROM is reported, and the stale copy it leaves behind is never
+     *  returned: neither while the mirror knows of it, nor after a restart, when only the
+     *  sequence numbers tell the copies apart. The first read repairs the stale copy
+     */
+    for(int restart = 0; restart < 2; restart++)
+    {
+        uint32_t page = 20 + restart;
+        uint32_t address = page * PAGE_DATA_SIZE;
+
+        TEST_CHECK(mirror.write_to_address(address, data, 40) == STM24256::EEPROM_OK);
+
+        chips[1].drop_writes = true;
+        TEST_CHECK(mirror.write_to_address(address, &data[100], 40) == STM24256::EEPROM_VERIFY_FAIL);
+        chips[1].drop_writes = false;
+        TEST_CHECK(!copies_match(chips, page));
+
+        STM24256_Mirror restarted(primary, secondary);
+        STM24256_Mirror &reader = restart ? restarted : mirror;
+
+        reader.reset_mirror_stats();
+        check_reads(reader, address, &data[100], 40);
+        reader.get_mirror_stats(stats);
+        TEST_CHECK(stats.repairs == 1);
+
+        TEST_CHECK(secondary.wait_for_write_cycle() == STM24256::EEPROM_OK);
+        TEST_CHECK(copies_match(chips, page));
+
+        /** Once the repair has completed both EEPROMs serve reads again
+         */
+        reader.reset_mirror_stats();
+        check_reads(reader, address, &data[100], 40);
+        reader.get_mirror_stats(stats);
+        TEST_CHECK(stats.reads[0] > 0 && stats.reads[1] > 0);
+        TEST_CHECK(stats.repairs == 0);
+    }
+
+    /** A copy torn part way through its page fails its CRC, so the other copy is returned and
+     *  the torn one repaired from it
+     */
+    uint32_t torn = 22 * PAGE_DATA_SIZE;
+    TEST_CHECK(mirror.write_to_address(torn, data, PAGE_DATA_SIZE) == STM24256::EEPROM_OK);
+    memset(&chips[0].mem[22 * PAGE_SIZE + 30], 0x00, PAGE_SIZE - 30);
+
+    mirror.reset_mirror_stats();
+    check_reads(mirror, torn, data, PAGE_DATA_SIZE);
+    mirror.get_mirror_stats(stats);
+    TEST_CHECK(stats.fallbacks == 1);
+    TEST_CHECK(stats.repairs == 1);
+
+    TEST_CHECK(primary.wait_for_write_cycle() == STM24256::EEPROM_OK);
+    TEST_CHECK(copies_match(chips, 22));
+
+    /** Sequence numbers are compared modulo 2^16, so a copy written just after the sequence
+     *  number wrapped is newer than one written just before, in either EEPROM
+     */
+    char expected[PAGE_SIZE];
+    for(int newer = 0; newer < 2; newer++)
+    {
+        int page = 23 + newer;
+        place_copy(chips[newer ^ 1], page, 0x11, 0xFFFF);
+        place_copy(chips[newer], page, 0x22, 0x0000);
+        memset(expected, 0x22, PAGE_DATA_SIZE);
+
+        STM24256_Mirror restarted(primary, secondary);
+        check_reads(restarted, page * PAGE_DATA_SIZE, expected, PAGE_DATA_SIZE);
+
+        TEST_CHECK(primary.wait_for_write_cycle() == STM24256::EEPROM_OK);
+        TEST_CHECK(secondary.wait_for_write_cycle() == STM24256::EEPROM_OK);
+        TEST_CHECK(copies_match(chips, page));
+
+        /** The next write to the page continues from the newer sequence number
+         */
+        TEST_CHECK(restarted.write_to_address(page * PAGE_DATA_SIZE, data, 1) == STM24256::EEPROM_OK);
+        TEST_CHECK(chips[0].mem[page * PAGE_SIZE + PAGE_DATA_SIZE] == 0x01);
+        TEST_CHECK(chips[0].mem[page * PAGE_SIZE + PAGE_DATA_SIZE + 1] == 0x00);
+    }
+
+    /** A repair dropped by the EEPROM holding the stale copy is noticed, so that copy is
+     *  checked again by every read and never returned, until a repair reaches it
+     */
+    place_copy(chips[0], 25, 0x22, 2);
+    place_copy(chips[1], 25, 0x11, 1);
+    memset(expected, 0x22, PAGE_DATA_SIZE);
+
+    {
+        STM24256_Mirror restarted(primary, secondary);
+
+        chips[1].drop_writes = true;
+        restarted.reset_mirror_stats();
+        check_reads(restarted, 25 * PAGE_DATA_SIZE, expected, PAGE_DATA_SIZE);
+        restarted.get_mirror_stats(stats);
+        TEST_CHECK(stats.repairs == 4);
+        TEST_CHECK(!copies_match(chips, 25));
+        chips[1].drop_writes = false;
+
+        check_reads(restarted, 25 * PAGE_DATA_SIZE, expected, PAGE_DATA_SIZE);
+        TEST_CHECK(copies_match(chips, 25));
+    }
+
+    /** A partial write merges into the newer copy even while the EEPROM holding it is busy,
+     *  rather than into the stale copy of the idle one
+     */
+    place_copy(chips[0], 26, 0x11, 1);
+    place_copy(chips[1], 26, 0x22, 2);
+    memset(expected, 0x22, PAGE_DATA_SIZE);
+    memcpy(&expected[4], data, 2);
+
+    {
+        STM24256_Mirror restarted(primary, secondary);
+
+        start_write_cycle(secondary, chips[1], 500);
+        TEST_CHECK(restarted.write_to_address(26 * PAGE_DATA_SIZE + 4, data, 2) == STM24256::EEPROM_OK);
+        check_reads(restarted, 26 * PAGE_DATA_SIZE, expected, PAGE_DATA_SIZE);
+        TEST_CHECK(copies_match(chips, 26));
+        TEST_CHECK(chips[0].mem[26 * PAGE_SIZE + PAGE_DATA_SIZE] == 0x03);
+    }
+
+    return test_result("test_mirror");
+}
@@ -0,0 +1,102 @@
+/**
+  * @file    test_read_ahead.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of the adaptive sequential read-ahead of the STM24256 driver
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+
+static const int READ_SIZE = 16;
+
+/** Read READ_SIZE bytes at address, checking them against the simulated memory, and return
+ *  how many bytes were clocked on the bus to do so
+ */
+static long read_and_count(STM24256 &eeprom, sim::Chip &chip, uint32_t address)
+{
+    char readback[READ_SIZE];
+
+    long bytes = sim::bytes;
+    TEST_CHECK(eeprom.read_from_address(address, readback, READ_SIZE) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[address], READ_SIZE) == 0);
+
+    return sim::bytes - bytes;
+}
+
+int main()
+{
+    sim::Chip chip;
+    for(int i = 0; i < (int)chip.mem.size(); i++)
+    {
+        chip.mem[i] = (uint8_t)(i * 13 + (i >> 8) + 1);
+    }
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+
+    static char buffer[256];
+    eeprom.set_read_ahead_buffer(buffer, sizeof(buffer));
+
+    /** The first read is fetched alone. Each following read that continues from the last and
+     *  is not already prefetched doubles the window, from twice the read up to the buffer size,
+     *  and the reads in between are served without touching the bus
+     */
+    TEST_CHECK(read_and_count(eeprom, chip, 0) <= READ_SIZE + 4);
+
+    const int windows[] = {32, 64, 128, 256, 256};
+    uint32_t address = READ_SIZE;
+    for(int window : windows)
+    {
+        long bytes = read_and_count(eeprom, chip, address);
+        TEST_CHECK(bytes >= window && bytes <= window + 4);
+
+        for(int offset = READ_SIZE; offset < window; offset += READ_SIZE)
+        {
+            TEST_CHECK(read_and_count(eeprom, chip, address + offset) == 0);
+        }
+
+        address += window;
+    }
+
+    /** A write through the driver updates the prefetched copy, which keeps serving reads
+     */
+    uint32_t written = address - 100;
+    const char update[4] = {0x12, 0x34, 0x56, 0x78};
+    TEST_CHECK(eeprom.write_to_address(written, update, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&chip.mem[written], update, 4) == 0);
+    TEST_CHECK(read_and_count(eeprom, chip, written - 4) == 0);
+
+    /** A write that fails verification drops the prefetched copy, so the next read is fetched
+     *  from the EEPROM rather than returning data that was never stored
+     */
+    const char rewrite[4] = {0x22, 0x22, 0x22, 0x22};
+    chip.drop_writes = true;
+    TEST_CHECK(eeprom.write_to_address(written, rewrite, 4) == STM24256::EEPROM_VERIFY_FAIL);
+    chip.drop_writes = false;
+    TEST_CHECK(read_and_count(eeprom, chip, written - 4) > 0);
+
+    /** A read elsewhere is fetched alone and starts the window afresh
+     */
+    TEST_CHECK(read_and_count(eeprom, chip, 20000) <= READ_SIZE + 4);
+    long bytes = read_and_count(eeprom, chip, 20000 + READ_SIZE);
+    TEST_CHECK(bytes >= 32 && bytes <= 32 + 4);
+
+    /** The window stops at the end of the memory array
+     */
+    const uint32_t end = STM24256::EEPROM_MEM_ARRAY_SIZE;
+    TEST_CHECK(read_and_count(eeprom, chip, end - 4 * READ_SIZE) <= READ_SIZE + 4);
+    TEST_CHECK(read_and_count(eeprom, chip, end - 3 * READ_SIZE) <= 2 * READ_SIZE + 4);
+    TEST_CHECK(read_and_count(eeprom, chip, end - 2 * READ_SIZE) == 0);
+    TEST_CHECK(read_and_count(eeprom, chip, end - READ_SIZE) <= READ_SIZE + 4);
+
+    /** Reads as long as the buffer bypass it
+     */
+    static char large[256];
+    TEST_CHECK(eeprom.read_from_address(0, large, sizeof(large)) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(large, &chip.mem[0], sizeof(large)) == 0);
+
+    return test_result("test_read_ahead");
+}
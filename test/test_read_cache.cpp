@@ -0,0 +1,116 @@
+/**
+  * @file    test_read_cache.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24xxx_Read_Cache
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_Read_Cache.h"
+
+static const int PAGE_SIZE = STM24256::EEPROM_PAGE_SIZE;
+
+/** Held statically, as the cache of an application would be
+ */
+static STM24256_Fixed_Read_Cache<4> cache;
+
+int main()
+{
+    sim::Chip chip;
+    sim::chips.push_back(&chip);
+    for(int i = 0; i < (int)chip.mem.size(); i++)
+    {
+        chip.mem[i] = (uint8_t)(i * 3 + (i >> 8));
+    }
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+    STM24256_Read_Cache::Cache_Stats_t stats;
+    char readback[PAGE_SIZE];
+
+    TEST_CHECK(cache.get_page_count() == 4);
+    eeprom.attach_read_cache(&cache);
+
+    /** A page read twice is fetched from the EEPROM once
+     */
+    long transactions = sim::transactions;
+    TEST_CHECK(eeprom.read_from_address(10, readback, 8) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.read_from_address(12, readback, 8) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[12], 8) == 0);
+    TEST_CHECK(sim::transactions - transactions <= 2);
+
+    cache.get_stats(stats);
+    TEST_CHECK(stats.misses == 1 && stats.hits == 1 && stats.evictions == 0);
+
+    /** Filling the cache with four more pages evicts the least recently used of them, the
+     *  first, which is then fetched again
+     */
+    for(int page = 1; page <= 4; page++)
+    {
+        TEST_CHECK(eeprom.read_from_address(page * PAGE_SIZE, readback, 4) == STM24256::EEPROM_OK);
+    }
+
+    cache.reset_stats();
+    TEST_CHECK(eeprom.read_from_address(4 * PAGE_SIZE, readback, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.read_from_address(0, readback, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[0], 4) == 0);
+    cache.get_stats(stats);
+    TEST_CHECK(stats.hits == 1 && stats.misses == 1 && stats.evictions == 1);
+
+    /** Writes through the driver keep cached pages coherent
+     */
+    const char update[4] = {0x12, 0x34, 0x56, 0x78};
+    TEST_CHECK(eeprom.write_to_address(4 * PAGE_SIZE + 2, update, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.read_from_address(4 * PAGE_SIZE + 2, readback, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, update, 4) == 0);
+
+    /** A write that fails verification leaves the cache holding what the EEPROM holds, not
+     *  what was written, whether verified after the write, page by page or by CRC
+     */
+    const char rewrite[4] = {0x22, 0x22, 0x22, 0x22};
+    const STM24256::EEPROM_Verify_Mode_t verify_modes[] = {STM24256::EEPROM_VERIFY_AFTER_WRITE,
+                                                          STM24256::EEPROM_VERIFY_EACH_PAGE,
+                                                          STM24256::EEPROM_VERIFY_CRC};
+    for(STM24256::EEPROM_Verify_Mode_t mode : verify_modes)
+    {
+        eeprom.set_verify_mode(mode);
+        TEST_CHECK(eeprom.read_from_address(4 * PAGE_SIZE + 2, readback, 4) == STM24256::EEPROM_OK);
+
+        chip.drop_writes = true;
+        TEST_CHECK(eeprom.write_to_address(4 * PAGE_SIZE + 2, rewrite, 4) == STM24256::EEPROM_VERIFY_FAIL);
+        chip.drop_writes = false;
+
+        TEST_CHECK(eeprom.read_from_address(4 * PAGE_SIZE + 2, readback, 4) == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, update, 4) == 0);
+    }
+
+    eeprom.set_verify_mode(STM24256::EEPROM_VERIFY_AFTER_WRITE);
+    eeprom.attach_read_cache(NULL);
+
+    /** A cache given no pages, or a negative amount of them, holds nothing and reads pass
+     *  straight through to the EEPROM
+     */
+    STM24256_Read_Cache::Cache_Page_t pages[1];
+    STM24256_Read_Cache empty(pages, 0);
+    STM24256_Read_Cache negative(pages, -1);
+    STM24256_Read_Cache missing(NULL, 4);
+
+    STM24256_Read_Cache *caches[] = {&empty, &negative, &missing};
+    for(STM24256_Read_Cache *uncached : caches)
+    {
+        TEST_CHECK(uncached->get_page_count() == 0);
+        TEST_CHECK(uncached->allocate(0) == NULL);
+
+        eeprom.attach_read_cache(uncached);
+        TEST_CHECK(eeprom.read_from_address(100, readback, 16) == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, &chip.mem[100], 16) == 0);
+        TEST_CHECK(eeprom.write_to_address(100, update, 4) == STM24256::EEPROM_OK);
+        TEST_CHECK(eeprom.read_from_address(100, readback, 4) == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, update, 4) == 0);
+        eeprom.attach_read_cache(NULL);
+    }
+
+    return test_result("test_read_cache");
+}
@@ -0,0 +1,129 @@
+/**
+  * @file    test_retry_policy.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of each mode and limit of the read retry policy
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+
+static char readback[64];
+
+/** Apply a retry policy and clear the retry totals
+ */
+static void set_policy(STM24256 &eeprom, STM24256::EEPROM_Retry_Mode_t mode, int max_attempts,
+                       int delay_us, int max_delay_us, int deadline_us)
+{
+    STM24256::EEPROM_Retry_Policy_t policy;
+    policy.mode = mode;
+    policy.max_attempts = max_attempts;
+    policy.delay_us = delay_us;
+    policy.max_delay_us = max_delay_us;
+    policy.deadline_us = deadline_us;
+
+    eeprom.set_retry_policy(policy);
+    eeprom.reset_retry_stats();
+}
+
+/** Check the retry totals, as far as they are given
+ */
+static void check_stats(STM24256 &eeprom, uint32_t attempts, uint32_t retries, uint32_t failures, uint32_t backoff_us)
+{
+    STM24256::EEPROM_Retry_Stats_t stats;
+    eeprom.get_retry_stats(stats);
+    TEST_CHECK(stats.attempts == attempts);
+    TEST_CHECK(stats.retries == retries);
+    TEST_CHECK(stats.failures == failures);
+    TEST_CHECK(stats.backoff_us == backoff_us);
+}
+
+/** Keep the EEPROM from acknowledging for busy_us, as a write cycle started by another bus
+ *  master would, which the driver knows nothing about
+ */
+static void occupy(sim::Chip &chip, uint64_t busy_us)
+{
+    chip.busy_until = sim::now_us + busy_us;
+}
+
+int main()
+{
+    sim::Chip chip;
+    for(int i = 0; i < (int)chip.mem.size(); i++)
+    {
+        chip.mem[i] = (uint8_t)(i * 3 + 1);
+    }
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+
+    /** EEPROM_RETRY_FIXED waits the same delay between each of its attempts. An EEPROM that
+     *  does not acknowledge fails each attempt as it is addressed
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_FIXED, 3, 200, 0, 0);
+    occupy(chip, 1000000);
+    TEST_CHECK(eeprom.read_from_address(0, readback, 16) == STM24256::EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY);
+    check_stats(eeprom, 3, 2, 1, 400);
+
+    /** EEPROM_RETRY_EXPONENTIAL doubles its delay after each attempt, up to max_delay_us
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_EXPONENTIAL, 5, 100, 300, 0);
+    TEST_CHECK(eeprom.read_from_address(0, readback, 16) == STM24256::EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY);
+    check_stats(eeprom, 5, 4, 1, 100 + 200 + 300 + 300);
+
+    /** With only a deadline, attempts continue until it has passed, and no backoff runs past it
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_FIXED, 0, 300, 0, 1000);
+    uint64_t start_us = sim::now_us;
+    TEST_CHECK(eeprom.read_from_address(0, readback, 16) == STM24256::EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY);
+    uint64_t elapsed_us = sim::now_us - start_us;
+    TEST_CHECK(elapsed_us >= 1000 && elapsed_us < 1000 + 200);
+
+    STM24256::EEPROM_Retry_Stats_t stats;
+    eeprom.get_retry_stats(stats);
+    TEST_CHECK(stats.failures == 1 && stats.attempts >= 3 && stats.backoff_us <= 1000);
+
+    /** A policy with neither limit makes a single attempt rather than retrying for ever
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_FIXED, 0, 100, 0, 0);
+    TEST_CHECK(eeprom.read_from_address(0, readback, 16) == STM24256::EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY);
+    check_stats(eeprom, 1, 0, 1, 0);
+
+    /** A read retried until the EEPROM responds again succeeds with its data
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_FIXED, 10, 1000, 0, 0);
+    occupy(chip, 2500);
+    start_us = sim::now_us;
+    TEST_CHECK(eeprom.read_from_address(100, readback, 16) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[100], 16) == 0);
+    check_stats(eeprom, 4, 3, 0, 3000);
+    uint64_t fixed_us = sim::now_us - start_us;
+
+    /** EEPROM_RETRY_ACK_POLL retries as soon as the EEPROM acknowledges, rather than after a
+     *  fixed delay
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_ACK_POLL, 2, 0, 0, 0);
+    occupy(chip, 2500);
+    start_us = sim::now_us;
+    TEST_CHECK(eeprom.read_from_address(200, readback, 16) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, &chip.mem[200], 16) == 0);
+    uint64_t poll_us = sim::now_us - start_us;
+
+    eeprom.get_retry_stats(stats);
+    TEST_CHECK(stats.attempts == 2 && stats.retries == 1 && stats.failures == 0);
+    TEST_CHECK(poll_us >= 2500 && poll_us < 2500 + 1000);
+    TEST_CHECK(poll_us < fixed_us);
+
+    /** A deadline bounds EEPROM_RETRY_ACK_POLL as well
+     */
+    set_policy(eeprom, STM24256::EEPROM_RETRY_ACK_POLL, 0, 0, 0, 2000);
+    occupy(chip, 1000000);
+    start_us = sim::now_us;
+    TEST_CHECK(eeprom.read_from_address(0, readback, 16) == STM24256::EEPROM_SET_OP_ADDRESS_FAIL_MEM_ARRAY);
+    elapsed_us = sim::now_us - start_us;
+    TEST_CHECK(elapsed_us >= 2000 && elapsed_us < 2000 + 200);
+
+    return test_result("test_retry_policy");
+}
@@ -0,0 +1,125 @@
+/**
+  * @file    test_scan_crc.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of scan_crc, with transfers completing both immediately and, as on
+  *          hardware, from a later callback
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_CRC.h"
+
+/** Checksum the whole of a part's memory array, and a region straddling each bank boundary,
+ *  comparing both with the CRC-32 of the simulated memory
+ */
+template<class EEPROM_Type>
+static void check_scans(sim::Chip &chip, EEPROM_Type &eeprom)
+{
+    const uint32_t size = EEPROM_Type::EEPROM_MEM_ARRAY_SIZE;
+    const char *mem = (const char *)&chip.mem[0];
+
+    uint32_t crc = 0;
+    TEST_CHECK(eeprom.scan_crc(0, size, crc) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(crc == STM24256_CRC::crc32(0, mem, size));
+
+    for(uint32_t boundary = EEPROM_Type::EEPROM_BANK_SIZE; boundary < size; boundary += EEPROM_Type::EEPROM_BANK_SIZE)
+    {
+        crc = 0;
+        TEST_CHECK(eeprom.scan_crc(boundary - 1001, 3000, crc) == EEPROM_Type::EEPROM_OK);
+        TEST_CHECK(crc == STM24256_CRC::crc32(0, &mem[boundary - 1001], 3000));
+    }
+
+    crc = 0;
+    TEST_CHECK(eeprom.scan_crc(7, 1, crc) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(crc == STM24256_CRC::crc32(0, &mem[7], 1));
+}
+
+int main()
+{
+    const int size = STM24256::EEPROM_MEM_ARRAY_SIZE;
+    const int chunks = size / EEPROM_SCAN_CHUNK_SIZE;
+
+    sim::Chip chip;
+    for(int i = 0; i < size; i++)
+    {
+        chip.mem[i] = (uint8_t)(i * 31 + (i >> 9) + 7);
+    }
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 1000000);
+
+    /** Without a bus hold quantum the whole array is read in chunks of EEPROM_SCAN_CHUNK_SIZE,
+     *  every one but the first continuing from the address counter in the background
+     */
+    long transactions = sim::transactions;
+    check_scans(chip, eeprom);
+    TEST_CHECK(sim::transactions - transactions <= chunks + 2 + 3 + 1);
+
+    /** A bus hold quantum shortens the chunks, so that no hold of the bus lasts longer than
+     *  an addressed read of one quantum
+     */
+    sim::reset();
+    sim::chips.push_back(&chip);
+    eeprom.set_bus_hold_quantum(64);
+
+    uint32_t crc = 0;
+    TEST_CHECK(eeprom.scan_crc(0, size, crc) == STM24256::EEPROM_OK);
+    TEST_CHECK(crc == STM24256_CRC::crc32(0, (const char *)&chip.mem[0], size));
+    TEST_CHECK(sim::transactions >= size / 64);
+
+    uint64_t longest_us = 0;
+    for(const sim::Hold &hold : sim::bus_holds(PB_7))
+    {
+        longest_us = std::max(longest_us, hold.end_us - hold.start_us);
+    }
+    TEST_CHECK(longest_us > 0 && longest_us <= (64 + 4) * 9);
+
+    eeprom.set_bus_hold_quantum(0);
+
+    /** Deferred transfers fill the buffer only after transfer has returned, so the chunk being
+     *  checksummed must be the one read before, and the one in flight must be waited for
+     */
+    sim::defer_transfers = true;
+    sim::deferred_transfers = 0;
+    uint64_t start_us = sim::now_us;
+    check_scans(chip, eeprom);
+    TEST_CHECK(sim::deferred_transfers >= chunks - 1);
+    TEST_CHECK(sim::early_unlocks == 0);
+    TEST_CHECK(sim::now_us - start_us >= (uint64_t)size * 9);
+
+    /** Chunks of a banked part end at each bank boundary, where the address counter of the
+     *  EEPROM rolls over within the bank rather than moving on to the next
+     */
+    for(int bank_bits = 1; bank_bits <= 2; bank_bits++)
+    {
+        sim::reset();
+        sim::Chip banked(256, 65536 << bank_bits);
+        banked.bank_bits = bank_bits;
+        for(int i = 0; i < banked.cap; i++)
+        {
+            banked.mem[i] = (uint8_t)(i * 7 + (i >> 16) + 1);
+        }
+        sim::chips.push_back(&banked);
+
+        sim::deferred_transfers = 0;
+        if(bank_bits == 1)
+        {
+            STM24M01 eeprom_m01(PA_0, PB_7, PB_6, 1000000);
+            check_scans(banked, eeprom_m01);
+        }
+        else
+        {
+            STM24M02 eeprom_m02(PA_0, PB_7, PB_6, 1000000);
+            check_scans(banked, eeprom_m02);
+        }
+        TEST_CHECK(sim::deferred_transfers > 0);
+        TEST_CHECK(sim::early_unlocks == 0);
+    }
+
+    sim::defer_transfers = false;
+
+    return test_result("test_scan_crc");
+}
@@ -0,0 +1,106 @@
+/**
+  * @file    test_skip_unchanged.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of the EEPROM_WRITE_SKIP_UNCHANGED write mode and its counters
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+
+static const int PAGE_SIZE = STM24256::EEPROM_PAGE_SIZE;
+
+static int completed_status = -1;
+
+static void on_complete(STM24256::EEPROM_Status_t status)
+{
+    completed_status = status;
+}
+
+/** Check the pages programmed and skipped since the counters were last reset, then reset them
+ */
+static void check_stats(STM24256 &eeprom, uint32_t programmed, uint32_t skipped)
+{
+    STM24256::EEPROM_Write_Stats_t stats;
+    eeprom.get_write_stats(stats);
+    TEST_CHECK(stats.pages_programmed == programmed);
+    TEST_CHECK(stats.pages_skipped == skipped);
+
+    eeprom.reset_write_stats();
+}
+
+int main()
+{
+    sim::Chip chip;
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+    eeprom.set_write_mode(STM24256::EEPROM_WRITE_SKIP_UNCHANGED);
+
+    char data[512];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 11 + 5);
+    }
+
+    /** Every page of the first write differs from the erased EEPROM
+     */
+    eeprom.reset_write_stats();
+    TEST_CHECK(eeprom.write_to_address(0, data, 4 * PAGE_SIZE) == STM24256::EEPROM_OK);
+    check_stats(eeprom, 4, 0);
+
+    /** Writing the same data again programs nothing, and so starts no write cycle
+     */
+    TEST_CHECK(eeprom.wait_for_write_cycle() == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.write_to_address(0, data, 4 * PAGE_SIZE) == STM24256::EEPROM_OK);
+    check_stats(eeprom, 0, 4);
+    TEST_CHECK(eeprom.is_write_cycle_complete());
+
+    /** Only the page holding a changed byte is programmed
+     */
+    data[2 * PAGE_SIZE + 5] ^= 0x55;
+    TEST_CHECK(eeprom.write_to_address(0, data, 4 * PAGE_SIZE) == STM24256::EEPROM_OK);
+    check_stats(eeprom, 1, 3);
+    TEST_CHECK(memcmp(&chip.mem[0], data, 4 * PAGE_SIZE) == 0);
+
+    /** Unaligned writes are compared slice by slice, partial slices included
+     */
+    data[PAGE_SIZE + 40] ^= 0x55;
+    TEST_CHECK(eeprom.write_to_address(30, &data[30], 2 * PAGE_SIZE) == STM24256::EEPROM_OK);
+    check_stats(eeprom, 1, 2);
+    TEST_CHECK(memcmp(&chip.mem[0], data, 4 * PAGE_SIZE) == 0);
+
+    /** write_async skips in the same way
+     */
+    EventQueue queue;
+    eeprom.set_event_queue(&queue);
+
+    data[3 * PAGE_SIZE] ^= 0x55;
+    TEST_CHECK(eeprom.write_async(0, data, 4 * PAGE_SIZE, on_complete) == STM24256::EEPROM_OK);
+    queue.dispatch_all();
+    TEST_CHECK(completed_status == STM24256::EEPROM_OK);
+    check_stats(eeprom, 1, 3);
+    TEST_CHECK(memcmp(&chip.mem[0], data, 4 * PAGE_SIZE) == 0);
+
+    /** A page that did not stick is programmed again rather than skipped, as it differs
+     */
+    data[10] ^= 0x55;
+    chip.drop_writes = true;
+    TEST_CHECK(eeprom.write_to_address(0, data, PAGE_SIZE) == STM24256::EEPROM_VERIFY_FAIL);
+    chip.drop_writes = false;
+    check_stats(eeprom, 1, 0);
+
+    TEST_CHECK(eeprom.write_to_address(0, data, PAGE_SIZE) == STM24256::EEPROM_OK);
+    check_stats(eeprom, 1, 0);
+    TEST_CHECK(memcmp(&chip.mem[0], data, PAGE_SIZE) == 0);
+
+    /** In EEPROM_WRITE_ALWAYS mode every page is programmed
+     */
+    eeprom.set_write_mode(STM24256::EEPROM_WRITE_ALWAYS);
+    TEST_CHECK(eeprom.write_to_address(0, data, 4 * PAGE_SIZE) == STM24256::EEPROM_OK);
+    check_stats(eeprom, 4, 0);
+
+    return test_result("test_skip_unchanged");
+}
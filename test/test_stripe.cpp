@@ -0,0 +1,106 @@
+/**
+  * @file    test_stripe.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24xxx_Stripe
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_Stripe.h"
+
+static const int MAX_BUSES = 3;
+
+/** Each bus has its own SDA, SCL and write control pins
+ */
+static const PinName SDA_PINS[MAX_BUSES] = {PB_7, PB_9, PB_11};
+static const PinName SCL_PINS[MAX_BUSES] = {PB_6, PB_8, PB_10};
+static const PinName WC_PINS[MAX_BUSES]  = {PA_0, PA_1, PA_2};
+
+static char data[8192];
+static char readback[8192];
+
+int main()
+{
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 13 + (i >> 8) + 1);
+    }
+
+    static sim::Chip chips[MAX_BUSES];
+    STM24256 *eeproms[MAX_BUSES];
+    for(int bus = 0; bus < MAX_BUSES; bus++)
+    {
+        chips[bus].sda = SDA_PINS[bus];
+        chips[bus].wc = WC_PINS[bus];
+        sim::chips.push_back(&chips[bus]);
+        eeproms[bus] = new STM24256(WC_PINS[bus], SDA_PINS[bus], SCL_PINS[bus], 400000);
+    }
+
+    for(int bus_count = 1; bus_count <= MAX_BUSES; bus_count++)
+    {
+        /** Each stripe is destroyed at the end of its iteration, stopping its worker threads
+         */
+        STM24256_Stripe stripe(eeproms, bus_count);
+        TEST_CHECK(stripe.get_size() == (uint32_t)bus_count * 32768);
+
+        /** Unaligned ranges of several lengths come back as written, from every bus
+         */
+        const int lengths[] = {1, 63, 64, 65, 1000, 5000};
+        for(int length : lengths)
+        {
+            uint32_t address = 37 + length;
+            memset(readback, 0, sizeof(readback));
+
+            TEST_CHECK(stripe.write_to_address(address, &data[bus_count], length) == STM24256::EEPROM_OK);
+            TEST_CHECK(stripe.read_from_address(address, readback, length) == STM24256::EEPROM_OK);
+            TEST_CHECK(memcmp(readback, &data[bus_count], length) == 0);
+        }
+
+        /** Page n of the stripe is page n / buses of the EEPROM on bus n % buses
+         */
+        TEST_CHECK(stripe.write_to_address(0, data, 64 * 2 * bus_count) == STM24256::EEPROM_OK);
+        for(int bus = 0; bus < bus_count; bus++)
+        {
+            TEST_CHECK(memcmp(&chips[bus].mem[64], &data[64 * (bus_count + bus)], 64) == 0);
+        }
+
+        /** A page dropped by the EEPROM on the last bus is reported
+         */
+        chips[bus_count - 1].drop_writes = true;
+        TEST_CHECK(stripe.write_to_address(0, &data[1], 64 * 2 * bus_count) == STM24256::EEPROM_VERIFY_FAIL);
+        chips[bus_count - 1].drop_writes = false;
+
+        TEST_CHECK(stripe.read_from_address(stripe.get_size() - 4, readback, 5) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+        TEST_CHECK(stripe.write_to_address(0xFFFFFFF0, data, 16) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+    }
+
+    /** A negative amount of EEPROMs makes an empty striped volume, which refuses every access
+     */
+    {
+        STM24256_Stripe stripe(eeproms, -1);
+
+        TEST_CHECK(stripe.get_size() == 0);
+        TEST_CHECK(stripe.read_from_address(0, readback, 4) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+        TEST_CHECK(stripe.write_to_address(0, data, 4) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+    }
+
+    /** Without verification the dropped page goes unnoticed, as with write_to_address(..., false)
+     */
+    {
+        STM24256_Stripe stripe(eeproms, MAX_BUSES, false);
+
+        chips[1].drop_writes = true;
+        TEST_CHECK(stripe.write_to_address(0, data, 1024) == STM24256::EEPROM_OK);
+        chips[1].drop_writes = false;
+    }
+
+    for(int bus = 0; bus < MAX_BUSES; bus++)
+    {
+        delete eeproms[bus];
+    }
+
+    return test_result("test_stripe");
+}
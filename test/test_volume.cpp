@@ -0,0 +1,147 @@
+/**
+  * @file    test_volume.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24xxx_Volume
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_Volume.h"
+
+static char data[8192];
+static char readback[8192];
+
+/** Write data across every EEPROM of a banked part's volume and read it back, checking that
+ *  each EEPROM on the bus received its own share
+ */
+template<class EEPROM_Type>
+static void check_banked_volume(int bank_bits)
+{
+    typedef STM24xxx_Volume<EEPROM_Type> Volume;
+
+    const int limit = Volume::EEPROM_VOLUME_CHIP_LIMIT;
+    const int page = EEPROM_Type::EEPROM_PAGE_SIZE;
+
+    sim::reset();
+    static sim::Chip *chips[EEPROM_VOLUME_MAX_CHIPS];
+    EEPROM_Type *eeproms[EEPROM_VOLUME_MAX_CHIPS];
+
+    /** Only the pins above the bank bits select an EEPROM. Eight drivers are offered, those
+     *  beyond the limit aliasing the first ones
+     */
+    for(int i = 0; i < EEPROM_VOLUME_MAX_CHIPS; i++)
+    {
+        int pins = (i % limit) << bank_bits;
+        if(i < limit)
+        {
+            chips[i] = new sim::Chip(page, EEPROM_Type::EEPROM_MEM_ARRAY_SIZE);
+            chips[i]->bank_bits = bank_bits;
+            chips[i]->devsel = 0xA0 | (pins << 1);
+            sim::chips.push_back(chips[i]);
+        }
+        eeproms[i] = new EEPROM_Type(PA_0, PB_7, PB_6, 1000000, pins);
+    }
+
+    Volume volume(eeproms, EEPROM_VOLUME_MAX_CHIPS);
+    TEST_CHECK(volume.get_size() == (uint32_t)limit * EEPROM_Type::EEPROM_MEM_ARRAY_SIZE);
+
+    int length = limit * page * 2;
+    TEST_CHECK(volume.write_to_address(page / 2, data, length) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(volume.read_from_address(page / 2, readback, length) == EEPROM_Type::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, data, length) == 0);
+
+    /** Page n of the volume is page n / limit of EEPROM n % limit
+     */
+    for(int i = 0; i < limit; i++)
+    {
+        TEST_CHECK(memcmp(&chips[i]->mem[page], &data[(limit + i) * page - page / 2], page) == 0);
+    }
+
+    for(int i = 0; i < EEPROM_VOLUME_MAX_CHIPS; i++)
+    {
+        delete eeproms[i];
+        if(i < limit)
+        {
+            delete chips[i];
+        }
+    }
+}
+
+int main()
+{
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 5 + (i >> 8) + 1);
+    }
+
+    /** Four EEPROMs on one bus, told apart by their E0 and E1 pins
+     */
+    sim::Chip chips[4];
+    STM24256 *eeproms[4];
+    for(int i = 0; i < 4; i++)
+    {
+        chips[i].devsel = 0xA0 | (i << 1);
+        sim::chips.push_back(&chips[i]);
+        eeproms[i] = new STM24256(PA_0, PB_7, PB_6, 400000, i);
+    }
+
+    STM24256_Volume volume(eeproms, 4);
+    TEST_CHECK(volume.get_size() == 4 * 32768);
+
+    /** Consecutive pages are interleaved across the EEPROMs
+     */
+    TEST_CHECK(volume.write_to_address(37, data, 3000) == STM24256::EEPROM_OK);
+    TEST_CHECK(volume.read_from_address(37, readback, 3000) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, data, 3000) == 0);
+    TEST_CHECK(memcmp(&chips[1].mem[0], &data[64 - 37], 64) == 0);
+    TEST_CHECK(memcmp(&chips[0].mem[64], &data[4 * 64 - 37], 64) == 0);
+
+    /** A page dropped by one EEPROM is reported
+     */
+    chips[2].drop_writes = true;
+    TEST_CHECK(volume.write_to_address(0, &data[1], 512) == STM24256::EEPROM_VERIFY_FAIL);
+    chips[2].drop_writes = false;
+
+    TEST_CHECK(volume.read_from_address(volume.get_size() - 4, readback, 4) == STM24256::EEPROM_OK);
+    TEST_CHECK(volume.read_from_address(volume.get_size() - 4, readback, 5) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+
+    /** A negative amount of EEPROMs makes an empty volume, which refuses every access
+     */
+    STM24256_Volume empty(eeproms, -1);
+    TEST_CHECK(empty.get_size() == 0);
+    TEST_CHECK(empty.read_from_address(0, readback, 4) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(empty.write_to_address(0, data, 4) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+
+    /** An even write to an odd address reaches each EEPROM as odd page slices, which program
+     *  exactly the bytes sent and leave their neighbours alone
+     */
+    TEST_CHECK(volume.write_to_address(4 * 64 + 61, &data[7], 6) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&chips[0].mem[125], &data[7], 3) == 0);
+    TEST_CHECK(memcmp(&chips[1].mem[64], &data[10], 3) == 0);
+    TEST_CHECK(chips[0].mem[124] == (uint8_t)data[1 + 4 * 64 + 60]);
+    TEST_CHECK(chips[1].mem[67] == (uint8_t)data[1 + 5 * 64 + 3]);
+
+    /** program_page applies the range checks of write_to_address, but not its even length rule
+     */
+    TEST_CHECK(eeproms[0]->program_page(125, &data[1], 3) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeproms[0]->program_page(125, data, 0) == STM24256::EEPROM_DATA_LENGTH_ZERO);
+    TEST_CHECK(eeproms[0]->program_page(125, data, 4) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeproms[0]->program_page(32768, data, 1) == STM24256::EEPROM_DATA_LENGTH_TOO_LONG);
+    TEST_CHECK(eeproms[0]->write_to_address(125, data, 3) == STM24256::EEPROM_DATA_LENGTH_ODD);
+    TEST_CHECK(eeproms[0]->wait_for_write_cycle() == STM24256::EEPROM_OK);
+
+    for(int i = 0; i < 4; i++)
+    {
+        delete eeproms[i];
+    }
+
+    /** Parts that select banks with address pins take fewer EEPROMs, rather than aliasing
+     */
+    check_banked_volume<STM24M01>(1);
+    check_banked_volume<STM24M02>(2);
+
+    return test_result("test_volume");
+}
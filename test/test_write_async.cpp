@@ -0,0 +1,158 @@
+/**
+  * @file    test_write_async.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of write_async, including an event queue that runs out of room
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+
+/** Status and amount of calls of the completion callback
+ */
+static int completed_status = -1;
+static int completed_calls = 0;
+
+static void on_complete(STM24256::EEPROM_Status_t status)
+{
+    completed_status = status;
+    completed_calls++;
+}
+
+static void reset_completion()
+{
+    completed_status = -1;
+    completed_calls = 0;
+}
+
+/** Driver destroyed by the event queue part way through its write
+ */
+static STM24256 *doomed = NULL;
+
+static void destroy_doomed()
+{
+    delete doomed;
+    doomed = NULL;
+}
+
+int main()
+{
+    sim::Chip chip;
+    chip.twr_jitter_us = 1000;
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+    EventQueue queue;
+
+    char data[1024];
+    char readback[1024];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 13 + 1);
+    }
+
+    /** Without an event queue there is nothing to run the write on
+     */
+    TEST_CHECK(eeprom.write_async(0, data, 64, on_complete) == STM24256::EEPROM_NO_EVENT_QUEUE);
+
+    eeprom.set_event_queue(&queue);
+
+    /** A write completes once, with its data on the EEPROM, and blocks other writes meanwhile
+     */
+    reset_completion();
+    TEST_CHECK(eeprom.write_async(0, data, 300, on_complete) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.is_write_async_pending());
+    TEST_CHECK(eeprom.write_async(0, data, 64, on_complete) == STM24256::EEPROM_BUSY);
+    TEST_CHECK(eeprom.write_to_address(512, data, 64) == STM24256::EEPROM_BUSY);
+    queue.dispatch_all();
+    TEST_CHECK(completed_status == STM24256::EEPROM_OK);
+    TEST_CHECK(completed_calls == 1);
+    TEST_CHECK(!eeprom.is_write_async_pending());
+    TEST_CHECK(memcmp(&chip.mem[0], data, 300) == 0);
+
+    /** A page programmed just before is still in its write cycle when the write starts
+     */
+    reset_completion();
+    TEST_CHECK(eeprom.program_page(0, data, 64) == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.write_async(64, &data[64], 256, on_complete) == STM24256::EEPROM_OK);
+    queue.dispatch_all();
+    TEST_CHECK(completed_status == STM24256::EEPROM_OK);
+    TEST_CHECK(eeprom.read_from_address(0, readback, 320) == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(readback, data, 320) == 0);
+
+    /** Each verify mode completes, and reports data that did not stick
+     */
+    const STM24256::EEPROM_Verify_Mode_t modes[] =
+    {
+        STM24256::EEPROM_VERIFY_AFTER_WRITE,
+        STM24256::EEPROM_VERIFY_EACH_PAGE,
+        STM24256::EEPROM_VERIFY_CRC
+    };
+
+    for(STM24256::EEPROM_Verify_Mode_t mode : modes)
+    {
+        eeprom.set_verify_mode(mode);
+
+        reset_completion();
+        TEST_CHECK(eeprom.write_async(100, &data[mode * 100], 400, on_complete) == STM24256::EEPROM_OK);
+        queue.dispatch_all();
+        TEST_CHECK(completed_status == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(&chip.mem[100], &data[mode * 100], 400) == 0);
+
+        chip.drop_writes = true;
+        reset_completion();
+        TEST_CHECK(eeprom.write_async(100, &data[mode * 100 + 1], 400, on_complete) == STM24256::EEPROM_OK);
+        queue.dispatch_all();
+        TEST_CHECK(completed_status == STM24256::EEPROM_VERIFY_FAIL);
+        TEST_CHECK(completed_calls == 1);
+        chip.drop_writes = false;
+    }
+
+    eeprom.set_verify_mode(STM24256::EEPROM_VERIFY_AFTER_WRITE);
+
+    /** A queue with no room for the first step refuses the write outright
+     */
+    reset_completion();
+    queue.limit = 0;
+    TEST_CHECK(eeprom.write_async(0, data, 128, on_complete) == STM24256::EEPROM_EVENT_QUEUE_FULL);
+    TEST_CHECK(!eeprom.is_write_async_pending());
+    TEST_CHECK(completed_calls == 0);
+
+    /** A queue that runs out of room part way through concludes the write rather than
+     *  leaving it pending for ever
+     */
+    queue.limit = 1;
+    TEST_CHECK(eeprom.write_async(0, data, 256, on_complete) == STM24256::EEPROM_OK);
+    queue.limit = 0;
+    queue.dispatch_all();
+    TEST_CHECK(completed_status == STM24256::EEPROM_EVENT_QUEUE_FULL);
+    TEST_CHECK(completed_calls == 1);
+    TEST_CHECK(!eeprom.is_write_async_pending());
+
+    /** The driver accepts writes again once the queue has room
+     */
+    queue.limit = (size_t)-1;
+    reset_completion();
+    TEST_CHECK(eeprom.write_async(0, &data[7], 256, on_complete) == STM24256::EEPROM_OK);
+    queue.dispatch_all();
+    TEST_CHECK(completed_status == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&chip.mem[0], &data[7], 256) == 0);
+
+    /** Destroying a driver part way through a write cancels its next step, so the queue never
+     *  calls into the destroyed driver and the callback is not invoked
+     */
+    reset_completion();
+    doomed = new STM24256(PA_0, PB_7, PB_6, 400000);
+    doomed->set_event_queue(&queue);
+    TEST_CHECK(doomed->write_async(0, data, 1024, on_complete) == STM24256::EEPROM_OK);
+    queue.call_in(20, destroy_doomed);
+    queue.dispatch_all();
+    TEST_CHECK(doomed == NULL);
+    TEST_CHECK(completed_calls == 0);
+    TEST_CHECK(memcmp(&chip.mem[0], data, 64) == 0);
+    TEST_CHECK(memcmp(&chip.mem[960], &data[960], 64) != 0);
+
+    return test_result("test_write_async");
+}
@@ -0,0 +1,134 @@
+/**
+  * @file    test_write_back_cache.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24xxx_Write_Back_Cache
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_Write_Back_Cache.h"
+
+static const int PAGE_SIZE = STM24256::EEPROM_PAGE_SIZE;
+
+static void nothing()
+{
+
+}
+
+/** Determine how many pages the EEPROM has programmed since its counters were last reset
+ */
+static uint32_t pages_programmed(STM24256 &eeprom)
+{
+    STM24256::EEPROM_Write_Stats_t stats;
+    eeprom.get_write_stats(stats);
+    return stats.pages_programmed;
+}
+
+int main()
+{
+    sim::Chip chip;
+    sim::chips.push_back(&chip);
+    std::fill(chip.mem.begin(), chip.mem.end(), 0x11);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+
+    char data[256];
+    char readback[256];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 9 + 5);
+    }
+
+    {
+        STM24256_Fixed_Write_Back_Cache<2> cache(eeprom);
+
+        /** Writes to the same page, of odd lengths too, are coalesced in RAM and read back from
+         *  it; nothing reaches the EEPROM until the cache is flushed, which programs the page once
+         */
+        eeprom.reset_write_stats();
+        TEST_CHECK(cache.write_to_address(3, data, 5) == STM24256::EEPROM_OK);
+        TEST_CHECK(cache.write_to_address(8, &data[5], 7) == STM24256::EEPROM_OK);
+        TEST_CHECK(cache.write_to_address(40, &data[12], 1) == STM24256::EEPROM_OK);
+        TEST_CHECK(cache.get_dirty_page_count() == 1);
+        TEST_CHECK(pages_programmed(eeprom) == 0);
+        TEST_CHECK(chip.mem[3] == 0x11);
+
+        TEST_CHECK(cache.read_from_address(0, readback, PAGE_SIZE) == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(&readback[3], data, 12) == 0);
+        TEST_CHECK(readback[2] == 0x11 && readback[15] == 0x11 && readback[40] == data[12]);
+
+        TEST_CHECK(cache.flush() == STM24256::EEPROM_OK);
+        TEST_CHECK(pages_programmed(eeprom) == 1);
+        TEST_CHECK(cache.get_dirty_page_count() == 0);
+        TEST_CHECK(memcmp(&chip.mem[3], data, 12) == 0);
+        TEST_CHECK(chip.mem[2] == 0x11 && chip.mem[15] == 0x11);
+
+        /** A third page evicts the least recently used of the two cached, programming it first
+         */
+        eeprom.reset_write_stats();
+        TEST_CHECK(cache.write_to_address(1 * PAGE_SIZE, data, 10) == STM24256::EEPROM_OK);
+        TEST_CHECK(cache.write_to_address(2 * PAGE_SIZE, data, 10) == STM24256::EEPROM_OK);
+        TEST_CHECK(cache.write_to_address(1 * PAGE_SIZE + 10, &data[10], 10) == STM24256::EEPROM_OK);
+        TEST_CHECK(pages_programmed(eeprom) == 0);
+
+        TEST_CHECK(cache.write_to_address(3 * PAGE_SIZE, data, 10) == STM24256::EEPROM_OK);
+        TEST_CHECK(pages_programmed(eeprom) == 1);
+        TEST_CHECK(memcmp(&chip.mem[2 * PAGE_SIZE], data, 10) == 0);
+        TEST_CHECK(chip.mem[1 * PAGE_SIZE] == 0x11);
+        TEST_CHECK(cache.get_dirty_page_count() == 2);
+
+        /** A page that fails to program stays dirty, to be retried by the next flush
+         */
+        chip.drop_writes = true;
+        TEST_CHECK(cache.flush() == STM24256::EEPROM_VERIFY_FAIL);
+        TEST_CHECK(cache.get_dirty_page_count() == 2);
+        chip.drop_writes = false;
+
+        /** A periodic flush programs the remaining pages from the event queue
+         */
+        events::EventQueue queue;
+        TEST_CHECK(cache.start_periodic_flush(&queue, 50) == STM24256::EEPROM_OK);
+        queue.call_in(120, nothing);
+        queue.dispatch_all();
+        TEST_CHECK(cache.get_dirty_page_count() == 0);
+        TEST_CHECK(memcmp(&chip.mem[1 * PAGE_SIZE], data, 20) == 0);
+        TEST_CHECK(memcmp(&chip.mem[3 * PAGE_SIZE], data, 10) == 0);
+        cache.stop_periodic_flush();
+
+        /** The destructor programs what is left
+         */
+        TEST_CHECK(cache.write_to_address(4 * PAGE_SIZE + 1, data, 3) == STM24256::EEPROM_OK);
+        TEST_CHECK(chip.mem[4 * PAGE_SIZE + 1] == 0x11);
+    }
+
+    TEST_CHECK(memcmp(&chip.mem[4 * PAGE_SIZE + 1], data, 3) == 0);
+
+    /** A cache given no pages, or a negative amount of them, programs writes straight through a
+     *  page at a time, keeping the bytes around them
+     */
+    STM24256_Write_Back_Cache::Cache_Page_t pages[1];
+    STM24256_Write_Back_Cache empty(eeprom, pages, 0);
+    STM24256_Write_Back_Cache negative(eeprom, pages, -1);
+    STM24256_Write_Back_Cache missing(eeprom, NULL, 4);
+
+    STM24256_Write_Back_Cache *caches[] = {&empty, &negative, &missing};
+    for(int i = 0; i < 3; i++)
+    {
+        uint32_t address = (10 + i) * PAGE_SIZE - 3;
+
+        eeprom.reset_write_stats();
+        TEST_CHECK(caches[i]->write_to_address(address, &data[i], 7) == STM24256::EEPROM_OK);
+        TEST_CHECK(pages_programmed(eeprom) == 2);
+        TEST_CHECK(caches[i]->get_dirty_page_count() == 0);
+        TEST_CHECK(memcmp(&chip.mem[address], &data[i], 7) == 0);
+        TEST_CHECK(chip.mem[address - 1] == 0x11 && chip.mem[address + 7] == 0x11);
+
+        TEST_CHECK(caches[i]->read_from_address(address, readback, 7) == STM24256::EEPROM_OK);
+        TEST_CHECK(memcmp(readback, &data[i], 7) == 0);
+    }
+
+    return test_result("test_write_back_cache");
+}
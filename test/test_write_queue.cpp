@@ -0,0 +1,145 @@
+/**
+  * @file    test_write_queue.cpp
+  * @version 2.4.1
+  * @author  Adam Mitchell
+  * @brief   Host test of STM24xxx_Write_Queue
+  */
+
+/** Includes
+ */
+#include "test.h"
+#include "STM24256.h"
+#include "STM24256_Write_Queue.h"
+
+static const int PAGE_SIZE = STM24256::EEPROM_PAGE_SIZE;
+static const int MAX_WRITES = 8;
+
+/** Status each queued write was completed with, and how many times it was completed
+ */
+static STM24256::EEPROM_Status_t statuses[MAX_WRITES];
+static int completions[MAX_WRITES];
+
+/** Build a completion callback recording the status of write n
+ */
+static STM24256::EEPROM_Callback_t record(int n)
+{
+    return [n](STM24256::EEPROM_Status_t status)
+    {
+        statuses[n] = status;
+        completions[n]++;
+    };
+}
+
+static uint32_t pages_programmed(STM24256 &eeprom)
+{
+    STM24256::EEPROM_Write_Stats_t stats;
+    eeprom.get_write_stats(stats);
+    return stats.pages_programmed;
+}
+
+int main()
+{
+    sim::Chip chip;
+    std::fill(chip.mem.begin(), chip.mem.end(), 0x11);
+    sim::chips.push_back(&chip);
+
+    STM24256 eeprom(PA_0, PB_7, PB_6, 400000);
+
+    static STM24256_Write_Queue::Queue_Page_t pages[3];
+    static STM24256_Write_Queue::Queue_Entry_t entries[4];
+    STM24256_Write_Queue queue(eeprom, pages, 3, entries, 4);
+
+    char data[256];
+    for(int i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (char)(i * 7 + 3);
+    }
+
+    /** Three odd length writes to one page, the last overlapping the first, and one write
+     *  spanning two more pages. Nothing reaches the EEPROM until the queue is processed
+     */
+    eeprom.reset_write_stats();
+    TEST_CHECK(queue.submit(5, data, 5, record(0)) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.submit(20, &data[5], 3, record(1)) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.submit(7, &data[8], 1, record(2)) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.submit(2 * PAGE_SIZE - 10, &data[9], 20, record(3)) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.get_pending_count() == 4);
+    TEST_CHECK(pages_programmed(eeprom) == 0);
+    TEST_CHECK(chip.mem[5] == 0x11);
+
+    /** Both the entries and the pages are full, and a refused write is not partially queued
+     */
+    TEST_CHECK(queue.submit(500, data, 2) == STM24256::EEPROM_BUSY);
+    TEST_CHECK(queue.get_pending_count() == 4);
+
+    /** Each page is programmed once, later writes winning where they overlap, bytes between
+     *  the writes keep their contents, and each write is told of its own completion
+     */
+    TEST_CHECK(queue.process() == STM24256::EEPROM_OK);
+    TEST_CHECK(pages_programmed(eeprom) == 3);
+    TEST_CHECK(queue.get_pending_count() == 0);
+
+    TEST_CHECK(chip.mem[4] == 0x11 && chip.mem[10] == 0x11 && chip.mem[19] == 0x11 && chip.mem[23] == 0x11);
+    TEST_CHECK(chip.mem[5] == (uint8_t)data[0] && chip.mem[6] == (uint8_t)data[1]);
+    TEST_CHECK(chip.mem[7] == (uint8_t)data[8]);
+    TEST_CHECK(chip.mem[8] == (uint8_t)data[3] && chip.mem[9] == (uint8_t)data[4]);
+    TEST_CHECK(memcmp(&chip.mem[20], &data[5], 3) == 0);
+    TEST_CHECK(memcmp(&chip.mem[2 * PAGE_SIZE - 10], &data[9], 20) == 0);
+    TEST_CHECK(chip.mem[2 * PAGE_SIZE + 10] == 0x11);
+
+    for(int n = 0; n < 4; n++)
+    {
+        TEST_CHECK(completions[n] == 1 && statuses[n] == STM24256::EEPROM_OK);
+    }
+
+    /** Pages that fail to program fail every write merged into them, each told once
+     */
+    TEST_CHECK(queue.submit(10 * PAGE_SIZE, data, 4, record(4)) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.submit(11 * PAGE_SIZE + 1, data, 3, record(5)) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.submit(11 * PAGE_SIZE - 2, data, 4, record(6)) == STM24256::EEPROM_OK);
+
+    std::vector<uint8_t> before = chip.mem;
+    chip.drop_writes = true;
+    TEST_CHECK(queue.process() == STM24256::EEPROM_VERIFY_FAIL);
+    chip.drop_writes = false;
+
+    for(int n = 4; n < 7; n++)
+    {
+        TEST_CHECK(completions[n] == 1 && statuses[n] == STM24256::EEPROM_VERIFY_FAIL);
+    }
+    TEST_CHECK(chip.mem == before);
+    TEST_CHECK(queue.get_pending_count() == 0);
+
+    /** A callback may submit a new write, as the queue is emptied before callbacks run
+     */
+    bool resubmitted = false;
+    TEST_CHECK(queue.submit(30 * PAGE_SIZE, data, 2, [&](STM24256::EEPROM_Status_t status)
+    {
+        resubmitted = status == STM24256::EEPROM_OK &&
+                      queue.submit(31 * PAGE_SIZE, &data[2], 2) == STM24256::EEPROM_OK;
+    }) == STM24256::EEPROM_OK);
+    TEST_CHECK(queue.process() == STM24256::EEPROM_OK);
+    TEST_CHECK(resubmitted && queue.get_pending_count() == 1);
+    TEST_CHECK(queue.process() == STM24256::EEPROM_OK);
+    TEST_CHECK(memcmp(&chip.mem[31 * PAGE_SIZE], &data[2], 2) == 0);
+
+    /** A queue given no pages or entries, or a negative amount of them, queues nothing and
+     *  leaves the EEPROM untouched
+     */
+    STM24256_Write_Queue negative_pages(eeprom, pages, -1, entries, 4);
+    STM24256_Write_Queue missing_pages(eeprom, NULL, 3, entries, 4);
+    STM24256_Write_Queue negative_entries(eeprom, pages, 3, entries, -1);
+    STM24256_Write_Queue missing_entries(eeprom, pages, 3, NULL, 4);
+
+    STM24256_Write_Queue *empty_queues[] = {&negative_pages, &missing_pages, &negative_entries, &missing_entries};
+    for(STM24256_Write_Queue *empty : empty_queues)
+    {
+        before = chip.mem;
+        TEST_CHECK(empty->submit(40 * PAGE_SIZE, data, 2) == STM24256::EEPROM_BUSY);
+        TEST_CHECK(empty->get_pending_count() == 0);
+        TEST_CHECK(empty->process() == STM24256::EEPROM_OK);
+        TEST_CHECK(chip.mem == before);
+    }
+
+    return test_result("test_write_queue");
+}